@@ -4,30 +4,105 @@
 #include "np_descr_t.h"
 #include "np_shape_t.h"
 #include "np_base_iterator.h"
-
+#include "np_mapped_file.h"
+#include "np_typed_view.h"
+#include "np_field_ref.h"
+#include "np_array_view.h"
+
+#include <algorithm>
+#include <array>
+#include <deque>
 #include <filesystem>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <memory_resource>
 #include <cstring>
 #include <fstream>
-#include <regex>
 
 namespace np
 {
 
+/**
+ * @brief The header_info struct holds everything the header of a npy file
+ * tells about its array, without the data.
+ */
+struct header_info
+{
+    descr_t      descr;
+    shape_t      shape;
+    bool         fortran_order = false;
+    std::uint8_t major_version = 0;
+    std::uint8_t minor_version = 0;
+    std::size_t  header_len    = 0; ///< size of the header dict, padding included
+    std::size_t  data_offset   = 0; ///< position of the first byte of data in the file
+};
+
+/**
+ * @brief The uninitialized_t struct is a tag used to construct an array
+ * without zeroing its data.
+ */
+struct uninitialized_t
+{
+    explicit uninitialized_t() = default;
+};
+
+/**
+ * @brief Tag to pass to the array ctor to leave its data uninitialized.
+ *
+ * i.e `np::array a(np::uninitialized, np::descr_t::make<float>(), {1024, 1024});`
+ */
+inline constexpr uninitialized_t uninitialized{};
+
+/**
+ * @brief The load_options struct tunes how array::load reads the data.
+ *
+ * i.e `np::array::load("file.npy", np::load_options{np::NativeEndian});`
+ */
+struct load_options
+{
+    /// Endianness to convert the data to as it is read, none to keep the
+    /// one of the file
+    std::optional<Endianness> target_endianness;
+};
+
 /**
  * @brief The array class represents the actual numpy ndarray
  */
 class array
 {
+    friend class npy_reader;
+    friend class npz_archive;
+    template<bool>
+    friend class basic_array_view;
 
 public:
     typedef base_iterator<array, false> iterator;
     typedef base_iterator<array, true>  const_iterator;
 
+    /// Alignment of the data allocated by the array
+    static constexpr std::size_t data_alignment = 64;
+
+    /// Alignment of the data of arrays bigger than a huge page
+    static constexpr std::size_t huge_data_alignment = 2 * 1024 * 1024;
+
 public:
     array() = default;
+    explicit array(std::pmr::memory_resource* mr);
     array(const array& c);
-    array(array&& m);
-    array(descr_t d, shape_t s, bool f = false);
+    array(const array& c, std::pmr::memory_resource* mr);
+    array(array&& m) noexcept;
+    array(descr_t d,
+          shape_t s,
+          bool f = false,
+          std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+    array(uninitialized_t,
+          descr_t d,
+          shape_t s,
+          bool f = false,
+          std::pmr::memory_resource* mr = std::pmr::get_default_resource());
 
     ~array();
 
@@ -38,6 +113,8 @@ public:
 
     void swap(array& o);
 
+    std::pmr::memory_resource* resource() const;
+
     std::size_t size() const;
     std::size_t size(std::size_t d) const;
     std::size_t dimensions() const;
@@ -61,88 +138,205 @@ public:
         return reinterpret_cast<const T*>(_data);
     }
 
-    static array load(const std::filesystem::path& file);
-    static array load(std::istream& stream);
-    static array load(std::FILE* file);
+    /**
+     * @brief Returns a view of the elements as T.
+     *
+     * The array must hold a single field of type T in native endianness. It is
+     * checked once here, accessing the elements through the view is then plain
+     * pointer arithmetic.
+     *
+     * i.e `for(float& f : a.as<float>()) f = 0;`
+     *
+     * @throw a np::error if the type does not match.
+     */
+    template<class T>
+    typed_view<T> as()
+    {
+        check_view_type<T>();
+        return typed_view<T>(reinterpret_cast<T*>(_data), _shape, _fortran_order);
+    }
 
-    template<class IOHelper, class Handle>
-    static array load(Handle& h)
+    /**
+     * @brief Returns a constant view of the elements as T.
+     * @see as()
+     */
+    template<class T>
+    typed_view<const T> as() const
     {
-        IOHelper io(h);
+        check_view_type<T>();
+        return typed_view<const T>(reinterpret_cast<const T*>(_data), _shape, _fortran_order);
+    }
 
-        //Check the magic phrase
-        char magic[7];
-        magic[6] = '\0';
-        io.read(magic, 6);
+    /**
+     * @brief Returns a handle on the @a name field of every element, as T.
+     *
+     * The field is looked up and its type checked once here, accessing the
+     * values through the handle is then plain pointer arithmetic.
+     *
+     * i.e `auto price = a.field<double>("price"); double p = price[3];`
+     *
+     * @throw a np::error if there is no such field or its type does not match.
+     */
+    template<class T>
+    field_ref<T> field(const std::string& name)
+    {
+        const type_t& t = field_type<T>(name);
+        return field_ref<T>(_data + t.offset(), _descr.stride(), empty() ? 0 : size());
+    }
 
-        if(std::strcmp(magic, "\x93NUMPY") != 0)
-            throw error("not a numpy file");
+    /**
+     * @brief Returns a constant handle on the @a name field, see field().
+     */
+    template<class T>
+    field_ref<const T> field(const std::string& name) const
+    {
+        const type_t& t = field_type<T>(name);
+        return field_ref<const T>(_data + t.offset(), _descr.stride(), empty() ? 0 : size());
+    }
 
-        //Check version
-        std::uint8_t maj, min;
-        io.read(&maj, 1);
-        io.read(&min, 1);
+    /**
+     * @brief Returns a view of the elements as records of type R, described by
+     * record_traits<R>.
+     *
+     * The layout of the array is checked once against the one of R: same field
+     * names, types and offsets, native endianness and a stride of
+     * `sizeof (R)`.
+     *
+     * @throw a np::error if the layouts do not match.
+     */
+    template<class R>
+    typed_view<R> as_records()
+    {
+        check_record_layout(record_traits<R>::descr(), sizeof (R));
+        return typed_view<R>(reinterpret_cast<R*>(_data), _shape, _fortran_order);
+    }
 
-        //read header len, little endian
-        std::size_t header_len = 0;
+    /**
+     * @brief Returns a constant view of the elements as records of type R.
+     * @see as_records()
+     */
+    template<class R>
+    typed_view<const R> as_records() const
+    {
+        check_record_layout(record_traits<R>::descr(), sizeof (R));
+        return typed_view<const R>(reinterpret_cast<const R*>(_data), _shape, _fortran_order);
+    }
 
-        if(maj == 1 && min == 0) // 2 bytes for v1.0
-        {
-            std::uint16_t tmp;
-            io.read(&tmp, 2);
-            header_len = byte_swap(tmp, LittleEndian, NativeEndian);
-        }
-        else if((maj == 2 || maj == 3) && min == 0) // 4 bytes for v2.0 and v3.0
-        {
-            io.read(&header_len, 4);
-            header_len = byte_swap(header_len, LittleEndian, NativeEndian);
-        }
-        else
-            throw error(std::to_string(maj)+"."+std::to_string(min) +
-                                     ": sorry, I can't read that version...");
+    /**
+     * @brief Makes a 1 dimension array of the @a count @a records of type R,
+     * copied in one go.
+     *
+     * record_traits<R> must be specialized, see NP_REFLECT.
+     *
+     * i.e
+     * ```
+     * std::vector<Trade> trades = ...;
+     * np::array a = np::array::from_records(trades.data(), trades.size());
+     * ```
+     */
+    template<class R>
+    static array from_records(const R* records,
+                              std::size_t count,
+                              std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+    {
+        static_assert(std::is_trivially_copyable_v<R>, "records must be trivially copyable");
 
-        //Read the header
-        std::string header(header_len, 0);
-        io.read(header.data(), header_len);
+        array a(uninitialized, record_traits<R>::descr(), {count}, false, mr);
+        a.check_record_layout(a._descr, sizeof (R));
 
-        bool fortran_order = false;
-        shape_t shape;
-        descr_t descr;
+        if(count > 0)
+            std::memcpy(a._data, records, count * sizeof (R));
 
-        // Parse the header
-        try
-        {
-            std::regex dict ("'([a-zA-Z0-9_-]+)':\\s*('[|=<>][a-zA-Z]\\d+(\\[[a_zA-Z]+\\])?'|\\[.*\\]|True|False|\\(.*\\))");
-            std::unordered_map<std::string, std::string> header_dict;
+        return a;
+    }
 
-            auto dict_begin = std::sregex_iterator(header.begin(), header.end(), dict);
-            auto dict_end = std::sregex_iterator();
+    /**
+     * @brief Makes a 1 dimension array of the @a records.
+     * @see from_records()
+     */
+    template<class R>
+    static array from_records(const std::vector<R>& records,
+                              std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+    {
+        return from_records(records.data(), records.size(), mr);
+    }
 
-            for(auto it = dict_begin; it != dict_end; ++it)
-                header_dict.emplace(it->str(1), it->str(2));
+    array_view view();
+    const_array_view view() const;
+
+    array_view slice(const std::vector<slice_t>& slices);
+    const_array_view slice(const std::vector<slice_t>& slices) const;
+
+    static array load(const std::filesystem::path& file,
+                      std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+    static array load(std::istream& stream,
+                      std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+    static array load(std::FILE* file,
+                      std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+    static array load(const std::filesystem::path& file,
+                      const load_options& options,
+                      std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+    static array load(std::istream& stream,
+                      const load_options& options,
+                      std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+    static array load(std::FILE* file,
+                      const load_options& options,
+                      std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+
+    static array map(const std::filesystem::path& file, MapMode mode = ReadOnly);
+    bool mapped() const;
+
+    static header_info inspect(const std::filesystem::path& file);
+    static header_info inspect(std::istream& stream);
+    static header_info inspect(std::FILE* file);
+
+    static std::vector<std::pair<std::filesystem::path, header_info>>
+    inspect_directory(const std::filesystem::path& dir,
+                      std::size_t max_open_files = 0,
+                      std::vector<std::pair<std::filesystem::path, std::string>>* errors = nullptr);
 
-            fortran_order = header_dict.at("fortran_order") == "True";
+    /**
+     * @brief Reads only the header from @a h, the data is left untouched.
+     * @throw a np::error on failure.
+     */
+    template<class IOHelper, class Handle>
+    static header_info inspect(Handle& h)
+    {
+        IOHelper io(h);
+        return read_header(io);
+    }
 
-            std::string shape_str = header_dict.at("shape");
-            std::regex shape_value("\\d+");
-            auto sbegin = std::sregex_iterator(shape_str.begin(), shape_str.end(), shape_value);
-            auto send   = std::sregex_iterator();
+    /**
+     * @brief Loads an array from @a h through @a IOHelper, its data is
+     * allocated from @a mr.
+     * @throw a np::error on failure.
+     */
+    template<class IOHelper, class Handle>
+    static array load(Handle& h,
+                      std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+    {
+        return load<IOHelper>(h, load_options(), mr);
+    }
 
-            for(auto it = sbegin; it != send; ++it)
-            {
-                std::string str = it->str();
-                std::size_t c = std::stoul(str);
-                shape.push_back(c);
-            }
+    /**
+     * @brief Loads an array from @a h through @a IOHelper according to
+     * @a options, its data is allocated from @a mr.
+     *
+     * With a target endianness the data is read by blocks, each one swapped
+     * right after being read while it is still in cache.
+     *
+     * @throw a np::error on failure.
+     */
+    template<class IOHelper, class Handle>
+    static array load(Handle& h,
+                      const load_options& options,
+                      std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+    {
+        IOHelper io(h);
 
-            descr = descr_t::from_string(header_dict.at("descr"));
-        }
-        catch(std::exception& e)
-        {
-            throw error("unable to parse numpy file header: " + std::string(e.what()));
-        }
+        header_info info = read_header(io);
 
-        array a(descr, shape, fortran_order);
+        array a(uninitialized, info.descr, info.shape, info.fortran_order, mr);
 
         std::size_t available = io.available();
         std::size_t expected = a.data_size();
@@ -152,11 +346,113 @@ public:
                         "only " + std::to_string(available) + "bytes available "
                         "where " + std::to_string(expected) + "bytes were expected");
 
-        io.read(a._data, expected);
+        if(!options.target_endianness || expected == 0)
+        {
+            io.read(a._data, expected);
+            return a;
+        }
+
+        Endianness e = *options.target_endianness;
+        std::size_t stride = a._descr.stride();
+        std::size_t count = a.size();
+        std::size_t block = std::max<std::size_t>(1, swap_block_size / stride);
+
+        for(std::size_t i = 0; i < count; i += block)
+        {
+            std::size_t n = std::min(block, count - i);
+            char* ptr = a._data + i * stride;
+
+            io.read(ptr, n * stride);
+            swap_elements(a._descr, ptr, n, e);
+        }
+
+        for(auto& field : a._descr._fields)
+            field.second._endianness = e;
 
         return a;
     }
 
+    static array load_rows(const std::filesystem::path& file,
+                           std::size_t first,
+                           std::size_t count,
+                           std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+    static array load_rows(std::istream& stream,
+                           std::size_t first,
+                           std::size_t count,
+                           std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+    static array load_rows(std::FILE* file,
+                           std::size_t first,
+                           std::size_t count,
+                           std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+
+    /**
+     * @brief Loads @a count rows starting at @a first from @a h.
+     *
+     * A row is a slice along the slowest varying axis, which is the first one
+     * in C order and the last one in Fortran order. Only the requested rows are
+     * read, the rest of the data is skipped.
+     *
+     * @throw a np::error on failure.
+     */
+    template<class IOHelper, class Handle>
+    static array load_rows(Handle& h,
+                           std::size_t first,
+                           std::size_t count,
+                           std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+    {
+        IOHelper io(h);
+
+        header_info info = read_header(io);
+
+        if(info.shape.empty())
+            throw error("can't load rows of a 0 dimension array");
+
+        std::size_t axis = info.fortran_order ? info.shape.size() - 1 : 0;
+
+        shape_t start(info.shape.size(), 0);
+        shape_t extent = info.shape;
+
+        start[axis]  = first;
+        extent[axis] = count;
+
+        return read_slice(io, info, start, extent, mr);
+    }
+
+    static array load_slice(const std::filesystem::path& file,
+                            const shape_t& start,
+                            const shape_t& extent,
+                            std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+    static array load_slice(std::istream& stream,
+                            const shape_t& start,
+                            const shape_t& extent,
+                            std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+    static array load_slice(std::FILE* file,
+                            const shape_t& start,
+                            const shape_t& extent,
+                            std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+
+    /**
+     * @brief Loads the hyperslab of size @a extent starting at the coordinates
+     * @a start from @a h.
+     *
+     * The data is read in contiguous runs, skipping directly to each of them.
+     * The bigger the extent along the fastest varying axes, the longer the runs.
+     *
+     * @throw a np::error on failure.
+     */
+    template<class IOHelper, class Handle>
+    static array load_slice(Handle& h,
+                            const shape_t& start,
+                            const shape_t& extent,
+                            std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+    {
+        IOHelper io(h);
+
+        header_info info = read_header(io);
+
+        return read_slice(io, info, start, extent, mr);
+    }
+
     void save(const std::filesystem::path& file) const;
     void save(std::ostream& stream) const;
     void save(FILE* file) const;
@@ -166,27 +462,27 @@ public:
     {
         IOHelper io(h);
 
-        const char* magic = "\x93NUMPY\x02\x00";
-        std::string header_str = header();
-
-        // magic + version + len + header
-        while((6 + 2 + 4 + header_str.length()) % 64 != 0)
-            header_str.push_back(' ');
-
-        std::size_t len = header_str.length();
-        len = byte_swap(len, NativeEndian, LittleEndian);
+        std::string preamble = make_preamble(_descr, _shape, _fortran_order);
 
-        io.write(magic, 8);
-        io.write(&len, 4);
-        io.write(header_str.data(), len);
+        io.write(preamble.data(), preamble.size());
         io.write(_data, data_size());
     }
 
     std::string header() const;
+    static std::string make_header(const descr_t& descr, const shape_t& shape, bool fortran_order);
+    static std::string make_preamble(const descr_t& descr, const shape_t& shape, bool fortran_order);
 
     void convert_to(Endianness e = NativeEndian);
 
-//    void transpose_order();
+    void reshape(shape_t shape);
+    void squeeze();
+    void squeeze(std::size_t axis);
+    void expand_dims(std::size_t axis);
+    void ravel();
+
+    void to_c_order(std::size_t threads = 1);
+    void to_fortran_order(std::size_t threads = 1);
+    array transpose(const std::vector<std::size_t>& axes = {}, std::size_t threads = 1) const;
 
     iterator begin();
     const_iterator begin() const;
@@ -202,8 +498,30 @@ public:
     iterator at_index(std::size_t index);
     const_iterator at_index(std::size_t index) const;
 
-    iterator at(std::vector<std::size_t> indices);
-    const_iterator at(std::vector<std::size_t> indices) const;
+    iterator at(const std::vector<std::size_t>& indices);
+    const_iterator at(const std::vector<std::size_t>& indices) const;
+
+    /**
+     * @brief Returns an iterator pointing at the coordinates @a indices, of a
+     * rank known at compile time.
+     *
+     * i.e `auto it = array.at<4>({i, j, k, l});`
+     */
+    template<std::size_t N>
+    iterator at(const std::array<std::size_t, N>& indices)
+    {
+        return at_index(index(indices));
+    }
+
+    /**
+     * @brief Returns a constant iterator pointing at the coordinates
+     * @a indices, of a rank known at compile time.
+     */
+    template<std::size_t N>
+    const_iterator at(const std::array<std::size_t, N>& indices) const
+    {
+        return at_index(index(indices));
+    }
 
     /**
      * @brief Returns an iterator pointing at the coordinates @a args
@@ -227,29 +545,332 @@ public:
         return at_index(index(args...));
     }
 
-    std::size_t index(std::vector<std::size_t> indices) const;
+    std::size_t index(const std::vector<std::size_t>& indices) const;
+
+    /**
+     * @brief returns the index corresponding to the coordinates @a indices, of
+     * a rank known at compile time.
+     * @throw a np::error if there are more coordinates than dimensions.
+     */
+    template<std::size_t N>
+    std::size_t index(const std::array<std::size_t, N>& indices) const
+    {
+        return index(indices.data(), N);
+    }
 
     /**
      * @brief returns the index corresponding to the coordinates @a args
+     *
+     * The missing trailing coordinates are taken as 0.
+     *
+     * @throw a np::error if there are more coordinates than dimensions.
      */
     template<class... Args>
     std::size_t index(Args... args) const
     {
-        if(_fortran_order)
-            return index_f_order(_shape, 0, args...);
-        else
-            return index_c_order(_shape, 0, args...);
+        const std::size_t indices[] = {static_cast<std::size_t>(args)...};
+        return index(indices, sizeof... (Args));
     }
 
+    /**
+     * @brief Returns the distance in elements between 2 consecutive elements
+     * along each axis.
+     */
+    inline const shape_t& strides() const { return _strides; }
+
     std::size_t data_size() const;
 
+    static std::size_t alignment(std::size_t size);
+
+private:
+    /**
+     * @brief Throws if the elements are not a single T in native endianness,
+     * packed without padding.
+     */
+    template<class T>
+    void check_view_type() const
+    {
+        if(_descr.size() != 1 || !_descr[0].second.is<T>(true))
+            throw error("bad type cast");
+
+        if(_descr.stride() != sizeof (T) || _descr[0].second.offset() != 0)
+            throw error("padded elements can't be viewed as T, use field()");
+    }
+
+    /**
+     * @brief Returns the type of the @a name field, checking it is a T in
+     * native endianness.
+     */
+    template<class T>
+    const type_t& field_type(const std::string& name) const
+    {
+        const type_t& t = _descr[name];
+
+        if(!t.is<T>(true))
+            throw error("bad type cast");
+
+        return t;
+    }
+
+    void check_record_layout(const descr_t& layout, std::size_t size) const;
+    void check_writable() const;
+
+    std::vector<std::ptrdiff_t> byte_strides() const;
+
+    /**
+     * @brief Returns the index of the element at the @a n coordinates
+     * @a indices, one multiplication per coordinate.
+     */
+    std::size_t index(const std::size_t* indices, std::size_t n) const
+    {
+        if(n > _strides.size())
+            throw error("size does not match");
+
+        std::size_t idx = 0;
+
+        for(std::size_t k = 0; k < n; k++)
+            idx += indices[k] * _strides[k];
+
+        return idx;
+    }
+
+    /// Size of the blocks swapped while loading, small enough to stay in cache
+    static constexpr std::size_t swap_block_size = 256 * 1024;
+
+    static void swap_elements(const descr_t& descr,
+                              char* data,
+                              std::size_t count,
+                              Endianness e);
+
+    /// Size of the tiles copied while transposing, 2 of them fit in L1
+    static constexpr std::size_t transpose_tile_bytes = 16 * 1024;
+
+    void set_shape(shape_t shape);
+
+    void set_order(bool fortran_order, std::size_t threads);
+
+    static void permute_copy(const char* src,
+                             const std::vector<std::ptrdiff_t>& src_strides,
+                             char* dst,
+                             std::size_t elem,
+                             const shape_t& shape,
+                             bool fortran_order,
+                             std::size_t threads);
+
+    /**
+     * @brief Reads the magic string, the version and the header dict from
+     * @a io, leaving it positioned at the first byte of the data.
+     * @throw a np::error on failure.
+     */
+    template<class IOHelper>
+    static header_info read_header(IOHelper& io)
+    {
+        header_info info;
+
+        //Check the magic phrase
+        char magic[7];
+        magic[6] = '\0';
+        io.read(magic, 6);
+
+        if(std::strcmp(magic, "\x93NUMPY") != 0)
+            throw error("not a numpy file");
+
+        //Check version
+        std::uint8_t maj, min;
+        io.read(&maj, 1);
+        io.read(&min, 1);
+
+        //read header len, little endian
+        std::size_t header_len = 0;
+
+        if(maj == 1 && min == 0) // 2 bytes for v1.0
+        {
+            std::uint16_t tmp;
+            io.read(&tmp, 2);
+            header_len = byte_swap(tmp, LittleEndian, NativeEndian);
+            info.data_offset = 6 + 2 + 2 + header_len;
+        }
+        else if((maj == 2 || maj == 3) && min == 0) // 4 bytes for v2.0 and v3.0
+        {
+            std::uint32_t tmp;
+            io.read(&tmp, 4);
+            header_len = byte_swap(tmp, LittleEndian, NativeEndian);
+            info.data_offset = 6 + 2 + 4 + header_len;
+        }
+        else
+            throw error(std::to_string(maj)+"."+std::to_string(min) +
+                                     ": sorry, I can't read that version...");
+
+        //Read the header
+        std::string header(header_len, 0);
+        io.read(header.data(), header_len);
+
+        // Parse the header
+        try
+        {
+            auto dict = details::literal::parse(header);
+
+            info.fortran_order = dict["fortran_order"].boolean();
+
+            auto& shape_tuple = dict["shape"];
+
+            for(std::size_t i = 0; i < shape_tuple.size(); i++)
+            {
+                auto c = shape_tuple[i].integer();
+
+                if(c < 0)
+                    throw error("negative dimension");
+
+                info.shape.push_back(static_cast<std::size_t>(c));
+            }
+
+            info.descr = descr_t::from_literal(dict["descr"]);
+        }
+        catch(std::exception& e)
+        {
+            throw error("unable to parse numpy file header: " + std::string(e.what()));
+        }
+
+        info.major_version = maj;
+        info.minor_version = min;
+        info.header_len    = header_len;
+
+        return info;
+    }
+
+    /**
+     * @brief Reads the hyperslab described by @a start and @a extent from
+     * @a io, which must be positioned at the first byte of the data.
+     */
+    template<class IOHelper>
+    static array read_slice(IOHelper& io,
+                            const header_info& info,
+                            const shape_t& start,
+                            const shape_t& extent,
+                            std::pmr::memory_resource* mr)
+    {
+        const shape_t& shape = info.shape;
+        std::size_t n = shape.size();
+
+        if(start.size() != n || extent.size() != n)
+            throw error("size does not match");
+
+        for(std::size_t d = 0; d < n; d++)
+        {
+            if(start[d] > shape[d] || extent[d] > shape[d] - start[d])
+                throw error("out of range");
+        }
+
+        array a(uninitialized, info.descr, extent, info.fortran_order, mr);
+
+        std::size_t full = n == 0 ? 0 : info.descr.stride();
+        for(auto& d : shape)
+            full *= d;
+
+        std::size_t available = io.available();
+
+        if(available < full)
+            throw error("error while reading file. "
+                        "only " + std::to_string(available) + "bytes available "
+                        "where " + std::to_string(full) + "bytes were expected");
+
+        if(a.data_size() == 0)
+            return a;
+
+        // Axes sorted from the slowest varying to the fastest, and their
+        // stride in bytes
+        shape_t axes(n);
+        shape_t strides(n);
+        std::size_t s = info.descr.stride();
+
+        for(std::size_t i = 0; i < n; i++)
+        {
+            std::size_t d = info.fortran_order ? i : n - 1 - i;
+            axes[n - 1 - i] = d;
+            strides[d] = s;
+            s *= shape[d];
+        }
+
+        // The run spans the fastest axes taken as a whole, plus the next one
+        std::size_t run = info.descr.stride();
+        std::size_t outer = n;
+
+        while(outer > 0)
+        {
+            std::size_t d = axes[--outer];
+            run *= extent[d];
+
+            if(extent[d] != shape[d])
+                break;
+        }
+
+        std::size_t base = 0;
+        for(std::size_t d = 0; d < n; d++)
+            base += start[d] * strides[d];
+
+        shape_t counter(outer, 0);
+        std::size_t pos = 0;
+        char* dst = a._data;
+
+        while(true)
+        {
+            std::size_t offset = base;
+            for(std::size_t i = 0; i < outer; i++)
+                offset += counter[i] * strides[axes[i]];
+
+            io.skip(offset - pos);
+            io.read(dst, run);
+
+            dst += run;
+            pos = offset + run;
+
+            std::size_t i = outer;
+            while(i > 0 && ++counter[i - 1] == extent[axes[i - 1]])
+                counter[--i] = 0;
+
+            if(i == 0)
+                break;
+        }
+
+        return a;
+    }
+
+    static array map(std::shared_ptr<mapped_file> mapping,
+                     std::size_t offset,
+                     std::size_t size);
+
+    char* allocate(std::size_t size);
+    void deallocate(char* data, std::size_t size);
+
+    void release();
+
 private:
     char*	_data = nullptr;
     shape_t	_shape;
+    shape_t	_strides; ///< element strides of each axis, see element_strides()
     descr_t	_descr;
     bool	_fortran_order = false;
+
+    std::shared_ptr<mapped_file> _mapping;
+    std::pmr::memory_resource*   _resource = std::pmr::get_default_resource();
 };
 
+/**
+ * @brief Copies the elements of the view in a new array of the same shape and
+ * order, its data allocated from @a mr.
+ */
+template<bool is_const>
+array basic_array_view<is_const>::contiguous(std::pmr::memory_resource* mr) const
+{
+    if(!_descr)
+        return array(mr);
+
+    array a(uninitialized, *_descr, _shape, _fortran_order, mr);
+    copy_to(a._data);
+
+    return a;
+}
+
 
 
 // ====== Utilities ============================================================
@@ -262,12 +883,29 @@ public:
     stream_reader(std::istream& stream);
 
     void read(void* ptr, std::size_t size);
+    void skip(std::size_t size);
     std::size_t available();
 
 private:
     std::istream& stream;
 };
 
+class memory_reader
+{
+public:
+    memory_reader(const char* data, std::size_t size);
+
+    void read(void* ptr, std::size_t size);
+    void skip(std::size_t size);
+    std::size_t available();
+    std::size_t position() const;
+
+private:
+    const char* data;
+    std::size_t size;
+    std::size_t pos = 0;
+};
+
 class stream_writer
 {
 public:
@@ -286,6 +924,7 @@ public:
 
     void read(void* ptr, std::size_t size);
     void write(const void* ptr, std::size_t size);
+    void skip(std::size_t size);
     std::size_t available();
 
 private:
@@ -307,11 +946,83 @@ private:
 
 
 
-typedef std::unordered_map<std::string, array> npz;
+/**
+ * @brief The npz class holds the named arrays of a npz file.
+ *
+ * Unlike a hash map it keeps the arrays in insertion order, which is the
+ * order of the archive for a loaded file and the order they are saved in, so
+ * the same arrays always give the same file. Arrays live in a deque, indexed
+ * by an open addressing table of positions that can be looked up with any
+ * string_view.
+ *
+ * Adding an array invalidates iterators but not references to the other
+ * arrays, as with std::unordered_map, so `z["copy"] = z["orig"]` is fine.
+ * Erasing one invalidates both iterators and references. Names must not be
+ * modified through iterators.
+ *
+ * i.e
+ * ```
+ * np::npz z;
+ * z.reserve(2);
+ * z.emplace("weights", some_array);
+ * z["bias"] = other_array;
+ *
+ * for(auto& p : z) // weights, then bias
+ *     std::cout << p.first << std::endl;
+ * ```
+ */
+class npz
+{
+public:
+    typedef std::pair<std::string, array>          value_type;
+    typedef std::deque<value_type>::iterator       iterator;
+    typedef std::deque<value_type>::const_iterator const_iterator;
+
+public:
+    npz() = default;
+
+    std::size_t size() const;
+    bool empty() const;
+    void reserve(std::size_t count);
+    void clear();
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    bool contains(std::string_view name) const;
+    std::size_t count(std::string_view name) const;
+    iterator find(std::string_view name);
+    const_iterator find(std::string_view name) const;
+
+    array& at(std::string_view name);
+    const array& at(std::string_view name) const;
+    array& operator[](std::string_view name);
+
+    std::pair<iterator, bool> emplace(std::string name, array a);
+    std::pair<iterator, bool> insert_or_assign(std::string name, array a);
+    std::size_t erase(std::string_view name);
+
+private:
+    std::size_t lookup(std::string_view name) const;
+    void rehash(std::size_t count);
+
+private:
+    std::deque<value_type>   _items;
+    std::vector<std::size_t> _index; ///< positions in _items, npos if empty
+};
+
+npz npz_load(const std::filesystem::path& file, std::size_t threads = 1);
+npz npz_map(const std::filesystem::path& file, MapMode mode = ReadOnly);
 
-npz npz_load(const std::filesystem::path& file);
+void npz_save(const npz& arrays,
+              const std::filesystem::path& file,
+              std::size_t threads = 1);
 
-void npz_save(const npz& arrays, const std::filesystem::path& file);
+void npz_save_compressed(const npz& arrays,
+                         const std::filesystem::path& file,
+                         int level = 6);
 
 }
 
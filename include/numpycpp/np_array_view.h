@@ -0,0 +1,701 @@
+#ifndef NP_ARRAY_VIEW_H
+#define NP_ARRAY_VIEW_H
+
+#include "np_descr_t.h"
+#include "np_shape_t.h"
+#include "np_base_iterator.h"
+
+#include <cstddef>
+#include <cstring>
+#include <memory_resource>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace np
+{
+
+class array;
+
+/**
+ * @brief The slice_t struct selects the indices start, start + step, ... up to
+ * stop excluded along one axis, as the python `start:stop:step`.
+ *
+ * Negative start and stop count from the end of the axis, out of range values
+ * are clamped and a missing start or stop means the whole axis in the
+ * direction of step.
+ *
+ * i.e
+ * ```
+ * np::slice_t{}                           // :
+ * np::slice_t{2, 10}                      // 2:10
+ * np::slice_t{std::nullopt, -1}           // :-1
+ * np::slice_t{std::nullopt, std::nullopt, -1} // ::-1
+ * ```
+ */
+struct slice_t
+{
+    slice_t(std::optional<std::ptrdiff_t> start = std::nullopt,
+            std::optional<std::ptrdiff_t> stop = std::nullopt,
+            std::ptrdiff_t step = 1)
+        : start(start), stop(stop), step(step) {}
+
+    std::optional<std::ptrdiff_t> start;
+    std::optional<std::ptrdiff_t> stop;
+    std::ptrdiff_t                step;
+};
+
+template<class View, bool is_const>
+class view_iterator;
+
+/**
+ * @brief The basic_array_view class looks at a strided subset of the elements
+ * of an array without copying them, see array::slice().
+ *
+ * A view is a data pointer, a shape and the distance in bytes between two
+ * consecutive elements along each axis. Those strides may be bigger than the
+ * element or negative, so slicing a view only changes these numbers.
+ *
+ * Iterating a view walks its elements in C order, or in Fortran order if the
+ * array was, just as iterating the array itself. contiguous() copies them in
+ * that order into a new array.
+ *
+ * The view does not own the data nor the descr_t, it must not outlive its
+ * array and is invalidated when the array is moved.
+ *
+ * i.e
+ * ```
+ * np::array a(np::descr_t::make<float>(), {100, 50});
+ *
+ * auto window = a.slice({{10, 20}, {std::nullopt, std::nullopt, 2}});
+ * auto row    = window[3];
+ *
+ * for(auto it : row)
+ *     it.value<float>() = 1.0f;
+ * ```
+ */
+template<bool is_const>
+class basic_array_view
+{
+    template<class, bool>
+    friend class view_iterator;
+    friend class basic_array_view<!is_const>;
+
+    typedef std::conditional_t<is_const, const char, char> byte_t;
+
+public:
+    typedef view_iterator<basic_array_view, false> iterator;
+    typedef view_iterator<basic_array_view, true>  const_iterator;
+    typedef std::vector<std::ptrdiff_t>            strides_t;
+
+public:
+    basic_array_view() = default;
+
+    /**
+     * @brief Views the elements described by @a descr, the first one at
+     * @a data and the next ones @a strides bytes apart along each axis of
+     * @a shape. They are iterated in Fortran order if @a fortran_order.
+     */
+    basic_array_view(byte_t* data,
+                     const descr_t* descr,
+                     shape_t shape,
+                     strides_t strides,
+                     bool fortran_order = false) :
+        _data(data),
+        _descr(descr),
+        _shape(std::move(shape)),
+        _strides(std::move(strides)),
+        _fortran_order(fortran_order)
+    {
+        if(_shape.size() != _strides.size())
+            throw error("size does not match");
+    }
+
+    /**
+     * @brief A constant view of the same elements as @a o.
+     */
+    template<bool other_is_const, typename std::enable_if_t<is_const && !other_is_const, int> = 0>
+    basic_array_view(const basic_array_view<other_is_const>& o) :
+        _data(o._data),
+        _descr(o._descr),
+        _shape(o._shape),
+        _strides(o._strides),
+        _fortran_order(o._fortran_order)
+    {}
+
+    inline byte_t*          data()          const { return _data;          }
+    inline const descr_t&   descr()         const { return *_descr;        }
+    inline const shape_t&   shape()         const { return _shape;         }
+    inline std::size_t      dimensions()    const { return _shape.size();  }
+    inline bool             fortran_order() const { return _fortran_order; }
+
+    /**
+     * @brief Returns the distance between 2 consecutive elements along each
+     * axis, in bytes.
+     */
+    inline const strides_t& strides() const { return _strides; }
+
+    /**
+     * @brief Returns the number of elements, 0 for a view of no dimension as
+     * for an array.
+     */
+    std::size_t size() const
+    {
+        if(_shape.empty() || !_descr)
+            return 0;
+
+        std::size_t s = 1;
+
+        for(auto d : _shape)
+            s *= d;
+
+        return s;
+    }
+
+    /**
+     * @brief Returns the size of the dimension @a d.
+     * @throw a np::error if @a d is out of range.
+     */
+    std::size_t size(std::size_t d) const
+    {
+        if(d >= _shape.size())
+            throw error("out of range");
+
+        return _shape[d];
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Returns the type of the element, for arrays of a single field.
+     * @throw a np::error if there are no fields.
+     */
+    const type_t& type() const
+    {
+        if(!_descr || _descr->size() == 0)
+            throw error("fields does not exists");
+
+        return (*_descr)[0].second;
+    }
+
+    /**
+     * @brief Returns the type of the given @a field.
+     * @throw a np::error if the field name does not exists.
+     */
+    const type_t& type(const std::string& field) const
+    {
+        return (*_descr)[field];
+    }
+
+    /**
+     * @brief Wether the elements are packed in memory in iteration order, in
+     * which case data() can be read in one go.
+     */
+    bool is_contiguous() const
+    {
+        std::ptrdiff_t s = static_cast<std::ptrdiff_t>(_descr ? _descr->stride() : 0);
+
+        for(std::size_t i = 0; i < _shape.size(); i++)
+        {
+            std::size_t d = fast_axis(i);
+
+            if(_shape[d] != 1 && _strides[d] != s)
+                return false;
+
+            s *= static_cast<std::ptrdiff_t>(_shape[d]);
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Returns the view of the elements selected by @a slices, one per
+     * axis starting from the first one. The axes left out are taken whole.
+     *
+     * i.e `auto every_other_row = v.slice({{std::nullopt, std::nullopt, 2}});`
+     *
+     * @throw a np::error if there are more slices than axes or a step is 0.
+     */
+    basic_array_view slice(const std::vector<slice_t>& slices) const
+    {
+        if(slices.size() > _shape.size())
+            throw error("too many slices");
+
+        basic_array_view r = *this;
+
+        for(std::size_t d = 0; d < slices.size(); d++)
+        {
+            std::ptrdiff_t first = 0;
+            std::size_t count = resolve(slices[d], _shape[d], first);
+
+            if(count > 0)
+                r._data += first * _strides[d];
+
+            r._shape[d]    = count;
+            r._strides[d] *= slices[d].step;
+        }
+
+        return r;
+    }
+
+    /**
+     * @brief Returns a view of the same elements with a new @a shape, read in
+     * the iteration order of this one.
+     *
+     * @throw a np::error if the number of elements does not match or the view
+     * is not contiguous, in which case reshape its contiguous() copy.
+     */
+    basic_array_view reshape(const shape_t& shape) const
+    {
+        std::size_t n = shape.empty() ? 0 : 1;
+
+        for(auto d : shape)
+            n *= d;
+
+        if(n != size())
+            throw error("cannot reshape view of size " + std::to_string(size()) +
+                        " into shape " + shape_to_string(shape));
+
+        if(!is_contiguous())
+            throw error("cannot reshape a non contiguous view");
+
+        shape_t elements = element_strides(shape, _fortran_order);
+
+        basic_array_view r = *this;
+        r._shape = shape;
+        r._strides.resize(shape.size());
+
+        for(std::size_t d = 0; d < shape.size(); d++)
+            r._strides[d] = static_cast<std::ptrdiff_t>(elements[d] * _descr->stride());
+
+        return r;
+    }
+
+    /**
+     * @brief Returns the view of the @a i th slice along the first axis, with
+     * one dimension less.
+     *
+     * i.e `auto row = matrix_view[3];`
+     *
+     * @throw a np::error if @a i is out of range or the view has less than 2
+     * dimensions, use at() to reach a single element.
+     */
+    basic_array_view operator[](std::size_t i) const
+    {
+        if(_shape.size() < 2)
+            throw error("can't take a slice of a view of less than 2 dimensions");
+
+        if(i >= _shape[0])
+            throw error("out of range");
+
+        basic_array_view r;
+        r._data          = _data + static_cast<std::ptrdiff_t>(i) * _strides[0];
+        r._descr         = _descr;
+        r._shape         = shape_t(_shape.begin() + 1, _shape.end());
+        r._strides       = strides_t(_strides.begin() + 1, _strides.end());
+        r._fortran_order = _fortran_order;
+
+        return r;
+    }
+
+    iterator begin()
+    {
+        return iterator(this, 0);
+    }
+
+    const_iterator begin() const
+    {
+        return cbegin();
+    }
+
+    const_iterator cbegin() const
+    {
+        return const_iterator(const_cast<basic_array_view*>(this), 0);
+    }
+
+    iterator end()
+    {
+        return iterator(this, size());
+    }
+
+    const_iterator end() const
+    {
+        return cend();
+    }
+
+    const_iterator cend() const
+    {
+        return const_iterator(const_cast<basic_array_view*>(this), size());
+    }
+
+    /**
+     * @brief Returns an iterator pointing at the @a index th element in
+     * iteration order.
+     * @throw a np::error if @a index is out of range.
+     */
+    iterator at_index(std::size_t index)
+    {
+        if(index >= size())
+            throw error("out of range");
+
+        return iterator(this, index);
+    }
+
+    /**
+     * @brief Returns a constant iterator pointing at the @a index th element in
+     * iteration order.
+     * @throw a np::error if @a index is out of range.
+     */
+    const_iterator at_index(std::size_t index) const
+    {
+        if(index >= size())
+            throw error("out of range");
+
+        return const_iterator(const_cast<basic_array_view*>(this), index);
+    }
+
+    /**
+     * @brief Returns an iterator pointing at the coordinates @a args
+     *
+     * i.e `auto it = view.at(1, 2, 3);`
+     *
+     * @throw a np::error if the coordinates don't match the shape.
+     */
+    template<class... Args>
+    iterator at(Args... args)
+    {
+        return at_index(index(args...));
+    }
+
+    /**
+     * @brief Returns a constant iterator pointing at the coordinates @a args
+     * @throw a np::error if the coordinates don't match the shape.
+     */
+    template<class... Args>
+    const_iterator at(Args... args) const
+    {
+        return at_index(index(args...));
+    }
+
+    /**
+     * @brief Returns the position in iteration order of the element at the
+     * coordinates @a args.
+     * @throw a np::error if the coordinates don't match the shape.
+     */
+    template<class... Args>
+    std::size_t index(Args... args) const
+    {
+        std::size_t coords[] = {static_cast<std::size_t>(args)...};
+
+        if(sizeof... (Args) != _shape.size())
+            throw error("size does not match");
+
+        std::size_t idx = 0;
+        std::size_t s = 1;
+
+        for(std::size_t i = 0; i < _shape.size(); i++)
+        {
+            std::size_t d = fast_axis(i);
+
+            if(coords[d] >= _shape[d])
+                throw error("out of range");
+
+            idx += coords[d] * s;
+            s *= _shape[d];
+        }
+
+        return idx;
+    }
+
+    /**
+     * @brief Copies the elements in iteration order to @a dst, which must hold
+     * size() elements.
+     *
+     * The elements are copied by runs as long as the layout allows, a whole
+     * row at a time for a view of full rows.
+     */
+    void copy_to(void* dst) const
+    {
+        std::size_t n = size();
+
+        if(n == 0)
+            return;
+
+        std::size_t elem = _descr->stride();
+        char* out = static_cast<char*>(dst);
+
+        // Axes merged into the run, the fastest ones whose elements are packed
+        std::size_t run = 1;
+        std::size_t inner = 0;
+        std::ptrdiff_t packed = static_cast<std::ptrdiff_t>(elem);
+
+        while(inner < _shape.size())
+        {
+            std::size_t d = fast_axis(inner);
+
+            if(_shape[d] != 1 && _strides[d] != packed)
+                break;
+
+            run    *= _shape[d];
+            packed *= static_cast<std::ptrdiff_t>(_shape[d]);
+            inner++;
+        }
+
+        // Strided copy along the first non packed axis
+        std::size_t    count  = 1;
+        std::ptrdiff_t stride = 0;
+
+        if(inner < _shape.size())
+        {
+            count  = _shape[fast_axis(inner)];
+            stride = _strides[fast_axis(inner)];
+            inner++;
+        }
+
+        std::size_t bytes = run * elem;
+        shape_t counter(_shape.size(), 0);
+        const char* base = _data;
+
+        for(std::size_t done = 0; done < n; done += run * count)
+        {
+            const char* src = base;
+
+            for(std::size_t k = 0; k < count; k++, src += stride, out += bytes)
+                std::memcpy(out, src, bytes);
+
+            // Next run along the outer axes
+            for(std::size_t i = inner; i < _shape.size(); i++)
+            {
+                std::size_t d = fast_axis(i);
+
+                if(++counter[d] < _shape[d])
+                {
+                    base += _strides[d];
+                    break;
+                }
+
+                base -= static_cast<std::ptrdiff_t>(_shape[d] - 1) * _strides[d];
+                counter[d] = 0;
+            }
+        }
+    }
+
+    array contiguous(std::pmr::memory_resource* mr = std::pmr::get_default_resource()) const;
+
+private:
+    /**
+     * @brief Returns the axis varying the @a i th fastest in iteration order.
+     */
+    std::size_t fast_axis(std::size_t i) const
+    {
+        return _fortran_order ? i : _shape.size() - 1 - i;
+    }
+
+    /**
+     * @brief Resolves @a s over an axis of size @a dim, returning the number of
+     * indices selected and storing the first one in @a first.
+     */
+    static std::size_t resolve(const slice_t& s, std::size_t dim, std::ptrdiff_t& first)
+    {
+        if(s.step == 0)
+            throw error("slice step can't be 0");
+
+        std::ptrdiff_t n = static_cast<std::ptrdiff_t>(dim);
+
+        auto adjust = [n](std::ptrdiff_t v, std::ptrdiff_t lo, std::ptrdiff_t hi)
+        {
+            if(v < 0)
+                v += n;
+
+            return v < lo ? lo : (v > hi ? hi : v);
+        };
+
+        std::ptrdiff_t start, stop;
+
+        if(s.step > 0)
+        {
+            start = s.start ? adjust(*s.start, 0, n) : 0;
+            stop  = s.stop  ? adjust(*s.stop,  0, n) : n;
+        }
+        else
+        {
+            start = s.start ? adjust(*s.start, -1, n - 1) : n - 1;
+            stop  = s.stop  ? adjust(*s.stop,  -1, n - 1) : -1;
+        }
+
+        first = start;
+
+        if(s.step > 0)
+            return stop > start ? static_cast<std::size_t>((stop - start + s.step - 1) / s.step) : 0;
+        else
+            return start > stop ? static_cast<std::size_t>((start - stop - s.step - 1) / -s.step) : 0;
+    }
+
+private:
+    byte_t*        _data          = nullptr;
+    const descr_t* _descr         = nullptr;
+    shape_t        _shape;
+    strides_t      _strides;
+    bool           _fortran_order = false;
+};
+
+typedef basic_array_view<false> array_view;
+typedef basic_array_view<true>  const_array_view;
+
+/**
+ * @brief The view_iterator class walks the elements of a view, giving the same
+ * access to them as the iterator of an array.
+ *
+ * It keeps the coordinates of the element, so stepping to the next one is
+ * adding the stride of the fastest axis, carrying to the slower axes at the
+ * end of a row.
+ */
+template<class View, bool is_const>
+class view_iterator : public base_iterator<View, is_const>
+{
+    template<bool>
+    friend class basic_array_view;
+    friend class view_iterator<View, !is_const>;
+
+    typedef base_iterator<View, is_const> base;
+
+public:
+    typedef std::ptrdiff_t difference_type;
+
+    view_iterator() = default;
+
+    /**
+     * @brief A constant iterator from an iterator.
+     */
+    template<bool other_is_const, typename std::enable_if_t<is_const && !other_is_const, int> = 0>
+    view_iterator(const view_iterator<View, other_is_const>& o) :
+        base(o),
+        _index(o._index),
+        _coords(o._coords)
+    {}
+
+    bool operator==(const view_iterator& o) const { return this->_array == o._array && _index == o._index; }
+    bool operator!=(const view_iterator& o) const { return !(*this == o);   }
+    bool operator<(const view_iterator& o)  const { return _index < o._index;  }
+    bool operator>(const view_iterator& o)  const { return _index > o._index;  }
+    bool operator<=(const view_iterator& o) const { return _index <= o._index; }
+    bool operator>=(const view_iterator& o) const { return _index >= o._index; }
+
+    /**
+     * @brief Position of the element in iteration order.
+     */
+    inline std::size_t index() const { return _index; }
+
+    view_iterator& operator++()
+    {
+        const View& v = *this->_array;
+        std::size_t n = v._shape.size();
+
+        _index++;
+
+        for(std::size_t i = 0; i < n; i++)
+        {
+            std::size_t d = v.fast_axis(i);
+
+            if(++_coords[d] < v._shape[d] || i == n - 1)
+            {
+                this->_data += v._strides[d];
+                break;
+            }
+
+            this->_data -= static_cast<std::ptrdiff_t>(v._shape[d] - 1) * v._strides[d];
+            _coords[d] = 0;
+        }
+
+        return *this;
+    }
+
+    view_iterator& operator--()
+    {
+        const View& v = *this->_array;
+        std::size_t n = v._shape.size();
+
+        _index--;
+
+        for(std::size_t i = 0; i < n; i++)
+        {
+            std::size_t d = v.fast_axis(i);
+
+            if(_coords[d] > 0 || i == n - 1)
+            {
+                --_coords[d];
+                this->_data -= v._strides[d];
+                break;
+            }
+
+            _coords[d] = v._shape[d] - 1;
+            this->_data += static_cast<std::ptrdiff_t>(v._shape[d] - 1) * v._strides[d];
+        }
+
+        return *this;
+    }
+
+    view_iterator operator++(int) { view_iterator r = *this; ++*this; return r; }
+    view_iterator operator--(int) { view_iterator r = *this; --*this; return r; }
+
+    view_iterator& operator+=(difference_type s) { seek(_index + s); return *this; }
+    view_iterator& operator-=(difference_type s) { seek(_index - s); return *this; }
+
+    view_iterator operator+(difference_type s) const { view_iterator r = *this; return r += s; }
+    view_iterator operator-(difference_type s) const { view_iterator r = *this; return r -= s; }
+
+    /**
+     * @brief Returns the number of element between this and @a it
+     */
+    difference_type operator-(const view_iterator& it) const
+    {
+        return static_cast<difference_type>(_index) - static_cast<difference_type>(it._index);
+    }
+
+private:
+    view_iterator(View* view, std::size_t index)
+    {
+        this->_array = view;
+        _coords.resize(view->_shape.size());
+        seek(index);
+    }
+
+    /**
+     * @brief Points at the @a index th element, the end one being past the
+     * last element along the slowest axis.
+     */
+    void seek(std::size_t index)
+    {
+        const View& v = *this->_array;
+        std::size_t n = v._shape.size();
+
+        _index = index;
+        this->_data = const_cast<char*>(v._data);
+
+        for(std::size_t i = 0; i < n; i++)
+        {
+            std::size_t d = v.fast_axis(i);
+
+            if(i == n - 1 || v._shape[d] == 0)
+                _coords[d] = index;
+            else
+            {
+                _coords[d] = index % v._shape[d];
+                index /= v._shape[d];
+            }
+
+            this->_data += static_cast<std::ptrdiff_t>(_coords[d]) * v._strides[d];
+        }
+    }
+
+private:
+    std::size_t _index = 0;
+    shape_t     _coords;
+};
+
+}
+
+#endif // NP_ARRAY_VIEW_H
@@ -28,6 +28,8 @@ std::uint32_t byte_swap32(std::uint32_t value);
 std::uint64_t byte_swap64(std::uint64_t value);
 
 void byte_swap(void* value, std::size_t size);
+void byte_swap(void* data, std::size_t width, std::size_t count);
+void byte_swap(void* data, std::size_t width, std::size_t count, std::size_t stride);
 
 /**
  * @brief Swaps the bytes of any value T
@@ -7,6 +7,8 @@
 #include <string>
 
 #include "np_type_t.h"
+#include "np_literal.h"
+#include "np_error.h"
 
 namespace np
 {
@@ -111,6 +113,9 @@ public:
 
     void swap(descr_t& o);
 
+    bool operator==(const descr_t& o) const;
+    bool operator!=(const descr_t& o) const;
+
     /**
      * @brief Appends a new field to the current descriptor.
      *
@@ -138,6 +143,40 @@ public:
         _fields.emplace_back(name, t);
     }
 
+    /**
+     * @brief Appends a new field at @a offset bytes in the element, the bytes
+     * between the previous field and this one are padding.
+     *
+     * This is useful to describe C++ structs, see NP_REFLECT.
+     *
+     * @throw a np::error if @a offset is before the end of the previous field.
+     */
+    void push_back(type_t t, std::string name, std::size_t offset)
+    {
+        if(offset < _stride)
+            throw error("overlapping fields");
+
+        _stride = offset;
+        push_back(std::move(t), std::move(name));
+    }
+
+    /**
+     * @brief Sets the size of an element to @a stride bytes, the bytes after
+     * the last field are padding.
+     *
+     * @throw a np::error if @a stride is before the end of the last field.
+     */
+    void set_stride(std::size_t stride)
+    {
+        std::size_t end = _fields.empty() ? 0 : _fields.back().second.offset() +
+                                                _fields.back().second.size();
+
+        if(stride < end)
+            throw error("stride too small");
+
+        _stride = stride;
+    }
+
     /**
      * @brief Makes a new descriptor from a type T with an optionnal name @a n
      */
@@ -166,7 +205,7 @@ public:
         return r;
     }
 
-    static descr_t from_string(const std::string& str);
+    static descr_t from_string(std::string_view str);
     std::string to_string() const;
 
     inline std::size_t stride() const { return _stride; }
@@ -185,14 +224,8 @@ public:
     std::size_t size() const;
 
 private:
-
-
-    static std::string extract(std::string::iterator& it,
-                               const std::string::iterator& end,
-                               char b,
-                               char e);
-
-    static std::pair<std::string, type_t> parse_tuple(const std::string& str);
+    static descr_t from_literal(const details::literal& l);
+    static std::pair<std::string, type_t> parse_tuple(const details::literal& l);
 
 private:
     fields_t    _fields;
@@ -0,0 +1,150 @@
+#ifndef NP_FIELD_REF_H
+#define NP_FIELD_REF_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace np
+{
+
+/**
+ * @brief The field_ref class gives direct access to one field of the
+ * elements of a structured array, see array::field().
+ *
+ * The field is looked up and its type checked once when the handle is made.
+ * The i th value is then `data() + i * stride()` bytes away, without any
+ * lookup.
+ *
+ * The handle does not own the data, it must not outlive its array.
+ *
+ * i.e
+ * ```
+ * auto price = a.field<double>("price");
+ *
+ * double total = 0;
+ * for(double p : price)
+ *     total += p;
+ *
+ * price[3] = 12.5;
+ * ```
+ */
+template<class T>
+class field_ref
+{
+    typedef std::conditional_t<std::is_const_v<T>, const char, char> byte_t;
+
+public:
+    /**
+     * @brief The iterator class walks the values of the field, stride bytes
+     * apart.
+     */
+    class iterator
+    {
+    public:
+        typedef T                               value_type;
+        typedef T&                              reference;
+        typedef T*                              pointer;
+        typedef std::ptrdiff_t                  difference_type;
+        typedef std::random_access_iterator_tag iterator_category;
+
+        iterator() = default;
+        iterator(byte_t* ptr, std::size_t stride) : _ptr(ptr), _stride(stride) {}
+
+        T& operator*() const { return *reinterpret_cast<T*>(_ptr); }
+        T* operator->() const { return reinterpret_cast<T*>(_ptr); }
+        T& operator[](difference_type n) const { return *(*this + n); }
+
+        iterator& operator++() { _ptr += _stride; return *this; }
+        iterator& operator--() { _ptr -= _stride; return *this; }
+        iterator operator++(int) { iterator r = *this; ++*this; return r; }
+        iterator operator--(int) { iterator r = *this; --*this; return r; }
+
+        iterator& operator+=(difference_type n) { _ptr += n * static_cast<difference_type>(_stride); return *this; }
+        iterator& operator-=(difference_type n) { _ptr -= n * static_cast<difference_type>(_stride); return *this; }
+
+        iterator operator+(difference_type n) const { iterator r = *this; return r += n; }
+        iterator operator-(difference_type n) const { iterator r = *this; return r -= n; }
+
+        difference_type operator-(const iterator& o) const
+        {
+            return (_ptr - o._ptr) / static_cast<difference_type>(_stride);
+        }
+
+        bool operator==(const iterator& o) const { return _ptr == o._ptr; }
+        bool operator!=(const iterator& o) const { return _ptr != o._ptr; }
+        bool operator<(const iterator& o)  const { return _ptr < o._ptr;  }
+        bool operator>(const iterator& o)  const { return _ptr > o._ptr;  }
+        bool operator<=(const iterator& o) const { return _ptr <= o._ptr; }
+        bool operator>=(const iterator& o) const { return _ptr >= o._ptr; }
+
+    private:
+        byte_t*     _ptr    = nullptr;
+        std::size_t _stride = 0;
+    };
+
+public:
+    field_ref() = default;
+
+    /**
+     * @brief References @a size values of the field, the first one at @a data
+     * and the next ones @a stride bytes apart.
+     */
+    field_ref(byte_t* data, std::size_t stride, std::size_t size) :
+        _data(data),
+        _stride(stride),
+        _size(size)
+    {}
+
+    /**
+     * @brief Returns the value of the @a i th element, without any check.
+     */
+    T& operator[](std::size_t i) const
+    {
+        return *reinterpret_cast<T*>(_data + i * _stride);
+    }
+
+    inline iterator    begin()  const { return iterator(_data, _stride); }
+    inline iterator    end()    const { return iterator(_data + _size * _stride, _stride); }
+    inline T*          data()   const { return reinterpret_cast<T*>(_data); }
+    inline std::size_t stride() const { return _stride;    } ///< in bytes
+    inline std::size_t size()   const { return _size;      }
+    inline bool        empty()  const { return _size == 0; }
+
+private:
+    byte_t*     _data   = nullptr;
+    std::size_t _stride = 0;
+    std::size_t _size   = 0;
+};
+
+/**
+ * @brief The record_traits struct tells how a C++ struct R maps to the
+ * elements of a structured array, see array::as_records().
+ *
+ * Specialize it with a static `descr()` returning the descr_t of R, its fields
+ * at the offsets of the struct members and a stride of `sizeof (R)`.
+ *
+ * i.e
+ * ```
+ * struct Point { double x; double y; };
+ *
+ * namespace np
+ * {
+ * template<>
+ * struct record_traits<Point>
+ * {
+ *     static descr_t descr()
+ *     {
+ *         return descr_t::make(field_t::make<double>("x"),
+ *                              field_t::make<double>("y"));
+ *     }
+ * };
+ * }
+ * ```
+ */
+template<class R>
+struct record_traits;
+
+}
+
+#endif // NP_FIELD_REF_H
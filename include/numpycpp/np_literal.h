@@ -0,0 +1,73 @@
+#ifndef NP_LITERAL_H
+#define NP_LITERAL_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace np
+{
+
+namespace details
+{
+
+/**
+ * @brief The literal class represents a python literal as found in numpy
+ * headers.
+ *
+ * It handles dicts, tuples, lists, quoted strings, integers, True, False and
+ * None. It is parsed in a single pass without copying any text: strings and
+ * dict keys are views into the parsed text, which must outlive the literal.
+ * Escape sequences in strings are kept as is.
+ */
+class literal
+{
+public:
+    enum Kind
+    {
+        None,
+        Bool,
+        Integer,
+        String,
+        Tuple,
+        List,
+        Dict
+    };
+
+public:
+    literal() = default;
+
+    static literal parse(std::string_view text);
+
+    Kind kind() const;
+    bool is(Kind k) const;
+
+    std::string_view text() const;
+
+    bool boolean() const;
+    std::int64_t integer() const;
+    std::string_view string() const;
+
+    std::size_t size() const;
+    const literal& operator[](std::size_t index) const;
+    const literal& operator[](std::string_view key) const;
+    const literal* find(std::string_view key) const;
+    std::string_view key(std::size_t index) const;
+
+private:
+    class parser;
+
+    Kind                          _kind    = None;
+    bool                          _boolean = false;
+    std::int64_t                  _integer = 0;
+    std::string_view              _text;
+    std::string_view              _string;
+    std::vector<literal>          _items;
+    std::vector<std::string_view> _keys;
+};
+
+}
+
+}
+
+#endif // NP_LITERAL_H
@@ -0,0 +1,54 @@
+#ifndef NP_MAPPED_FILE_H
+#define NP_MAPPED_FILE_H
+
+#include <filesystem>
+#include <cstddef>
+
+namespace np
+{
+
+/**
+ * @brief The MapMode enum defines how a file is mapped into memory.
+ */
+enum MapMode
+{
+    ReadOnly,    ///< Pages are read only, writing to them is undefined behaviour
+    CopyOnWrite, ///< Pages are writable but changes never reach the file
+    ReadWrite    ///< Pages are writable and changes are written back to the file
+};
+
+/**
+ * @brief The mapped_file class is a RAII wrapper around a memory mapped file.
+ *
+ * It is not copyable on purpose, share it through a std::shared_ptr so every
+ * array pointing into the mapping keeps it alive.
+ */
+class mapped_file
+{
+public:
+    mapped_file(const std::filesystem::path& file, MapMode mode = ReadOnly);
+    ~mapped_file();
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    char* data() const;
+    std::size_t size() const;
+    MapMode mode() const;
+
+    void sync();
+
+private:
+    char*       _data = nullptr;
+    std::size_t _size = 0;
+    MapMode     _mode = ReadOnly;
+
+#ifdef _WIN32
+    void* _file    = nullptr;
+    void* _mapping = nullptr;
+#endif
+};
+
+}
+
+#endif // NP_MAPPED_FILE_H
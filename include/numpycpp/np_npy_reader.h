@@ -0,0 +1,79 @@
+#ifndef NP_NPY_READER_H
+#define NP_NPY_READER_H
+
+#include "np_array.h"
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace np
+{
+
+/**
+ * @brief The npy_reader class reads a npy file by chunks of rows, so files
+ * bigger than the memory can be processed.
+ *
+ * A row is a slice along the slowest varying axis, the first one in C order
+ * and the last one in Fortran order, so each chunk is a contiguous part of
+ * the file. With read ahead enabled, the next chunk is read on a background
+ * thread while the current one is being processed.
+ *
+ * At most two chunks are held in memory: the one being read and the one
+ * returned by next(). Passing back the same array to next() recycles its
+ * buffer.
+ *
+ * i.e
+ * ```
+ * np::npy_reader r("file.npy", 4096);
+ * np::array chunk;
+ *
+ * while(r.next(chunk))
+ * {
+ *     // chunk holds up to 4096 rows
+ * }
+ * ```
+ */
+class npy_reader
+{
+public:
+    npy_reader(const std::filesystem::path& file,
+               std::size_t chunk_rows,
+               bool read_ahead = true);
+    ~npy_reader();
+
+    npy_reader(const npy_reader&) = delete;
+    npy_reader& operator=(const npy_reader&) = delete;
+
+    const header_info& info() const;
+    std::size_t rows() const;
+    std::size_t chunk_rows() const;
+
+    bool next(array& chunk);
+
+private:
+    bool read_chunk(array& chunk);
+    void read_ahead();
+
+private:
+    std::FILE*  _file = nullptr;
+    header_info _info;
+    std::size_t _rows       = 0;
+    std::size_t _chunk_rows = 0;
+    std::size_t _read_rows  = 0;
+
+    // Read ahead state
+    std::thread             _thread;
+    std::mutex              _mutex;
+    std::condition_variable _cv;
+    array                   _ahead;
+    bool                    _ahead_ready = false;
+    bool                    _ahead_end   = false;
+    bool                    _stop        = false;
+    std::exception_ptr      _error;
+};
+
+}
+
+#endif // NP_NPY_READER_H
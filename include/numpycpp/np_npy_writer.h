@@ -0,0 +1,65 @@
+#ifndef NP_NPY_WRITER_H
+#define NP_NPY_WRITER_H
+
+#include "np_array.h"
+
+namespace np
+{
+
+/**
+ * @brief The npy_writer class writes a npy file row by row, when its final
+ * length is not known in advance.
+ *
+ * A row is a slice along the slowest varying axis, the first one in C order
+ * and the last one in Fortran order, so appending rows only ever appends
+ * bytes to the file. The header is written with room for the biggest
+ * possible row count and rewritten with the actual one on close(), so the
+ * data never has to move.
+ *
+ * i.e
+ * ```
+ * np::npy_writer w("file.npy", np::descr_t::make<float>(), {3});
+ * w.append(some_floats, 10); // 10 rows of 3 floats
+ * w.append(another_array);   // an array of shape {n, 3}
+ * w.close();                 // file.npy now contains a {10 + n, 3} array
+ * ```
+ */
+class npy_writer
+{
+public:
+    npy_writer(const std::filesystem::path& file,
+               descr_t descr,
+               shape_t row_shape = {},
+               bool fortran_order = false);
+    ~npy_writer();
+
+    npy_writer(const npy_writer&) = delete;
+    npy_writer& operator=(const npy_writer&) = delete;
+
+    void append(const void* data, std::size_t rows);
+    void append(const array& a);
+
+    std::size_t rows() const;
+    std::size_t row_size() const;
+    shape_t shape() const;
+    bool is_open() const;
+
+    void close();
+
+private:
+    shape_t shape(std::size_t rows) const;
+    void write_header(std::FILE* f, std::size_t rows);
+
+private:
+    std::FILE*  _file = nullptr;
+    descr_t     _descr;
+    shape_t     _row_shape;
+    bool        _fortran_order = false;
+    std::size_t _rows          = 0;
+    std::size_t _row_size      = 0;
+    std::size_t _header_len    = 0;
+};
+
+}
+
+#endif // NP_NPY_WRITER_H
@@ -0,0 +1,92 @@
+#ifndef NP_NPZ_ARCHIVE_H
+#define NP_NPZ_ARCHIVE_H
+
+#include "np_array.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace np
+{
+
+/**
+ * @brief The npz_archive class gives access to the arrays of a npz file
+ * without loading all of them.
+ *
+ * Only the central directory of the zip file is read when opening it. Each
+ * array is then read on demand, decompressed straight into its own buffer.
+ *
+ * Every call opens its own handle on the file, so a npz_archive can be used
+ * from several threads at once.
+ *
+ * ZIP64 archives, as written by numpy past 4GB, are supported.
+ *
+ * When opened with a MapMode, the whole archive is mapped in memory and the
+ * arrays stored without compression, as written by `np.savez`, are returned
+ * as views into the mapping: nothing is read, allocated nor checked against
+ * its CRC. Compressed arrays are still inflated in their own buffer. Mapping
+ * an archive ReadWrite is not supported as writing to an array would
+ * invalidate the CRC of its member.
+ *
+ * i.e
+ * ```
+ * np::npz_archive z("file.npz");
+ *
+ * for(auto& name : z.names())
+ *     std::cout << name << " " << np::shape_to_string(z.inspect(name).shape);
+ *
+ * np::array a = z.load("my_array");
+ *
+ * np::npz_archive m("file.npz", np::ReadOnly);
+ * np::array b = m.load("my_array"); // b.mapped() if stored uncompressed
+ * ```
+ */
+class npz_archive
+{
+public:
+    /**
+     * @brief The entry struct describes a member of the zip file as found in
+     * its central directory.
+     */
+    struct entry
+    {
+        std::string   name;                ///< array name, without .npy
+        std::string   file_name;           ///< member name in the zip file
+        std::uint16_t flags           = 0;
+        std::uint16_t method          = 0; ///< 0 for stored, 8 for deflate
+        std::uint32_t crc             = 0;
+        std::uint64_t compressed_size = 0;
+        std::uint64_t size            = 0;
+        std::uint64_t offset          = 0; ///< position of the local header
+    };
+
+public:
+    npz_archive(const std::filesystem::path& file);
+    npz_archive(const std::filesystem::path& file, MapMode mode);
+
+    const std::filesystem::path& path() const;
+    bool mapped() const;
+
+    std::size_t size() const;
+    const std::vector<std::string>& names() const;
+    bool contains(const std::string& name) const;
+    const entry& at(const std::string& name) const;
+
+    header_info inspect(const std::string& name) const;
+    array load(const std::string& name,
+               std::pmr::memory_resource* mr = std::pmr::get_default_resource()) const;
+
+private:
+    std::filesystem::path                        _path;
+    std::vector<std::string>                     _names;
+    std::vector<entry>                           _entries;
+    std::unordered_map<std::string, std::size_t> _lookup;
+    std::shared_ptr<mapped_file>                 _mapping;
+};
+
+}
+
+#endif // NP_NPZ_ARCHIVE_H
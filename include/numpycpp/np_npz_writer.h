@@ -0,0 +1,115 @@
+#ifndef NP_NPZ_WRITER_H
+#define NP_NPZ_WRITER_H
+
+#include "np_array.h"
+
+#include <memory>
+
+namespace np
+{
+
+namespace details
+{
+class zip_writer;
+}
+
+/**
+ * @brief The npz_member_writer class appends the rows of an array streamed
+ * into a npz file, see npz_writer::add_stream().
+ *
+ * A row is a slice along the slowest varying axis, the first one in C order
+ * and the last one in Fortran order. Every row announced by the shape given
+ * to add_stream() must be appended before close().
+ *
+ * It must not outlive the npz_writer it comes from.
+ */
+class npz_member_writer
+{
+public:
+    npz_member_writer(npz_member_writer&& other) noexcept;
+    ~npz_member_writer();
+
+    npz_member_writer(const npz_member_writer&) = delete;
+    npz_member_writer& operator=(const npz_member_writer&) = delete;
+    npz_member_writer& operator=(npz_member_writer&&) = delete;
+
+    void append(const void* data, std::size_t rows);
+    void append(const array& a);
+
+    std::size_t rows() const;
+    std::size_t total_rows() const;
+    std::size_t row_size() const;
+    bool is_open() const;
+
+    void close();
+
+private:
+    friend class npz_writer;
+
+    npz_member_writer(details::zip_writer* zip,
+                      descr_t descr,
+                      shape_t shape,
+                      bool fortran_order);
+
+private:
+    details::zip_writer* _zip = nullptr;
+    descr_t              _descr;
+    shape_t              _shape;
+    bool                 _fortran_order = false;
+    std::size_t          _rows          = 0;
+    std::size_t          _total_rows    = 0;
+    std::size_t          _row_size      = 0;
+};
+
+/**
+ * @brief The npz_writer class writes a npz file one array at a time, so the
+ * arrays never have to be all in memory at once.
+ *
+ * Each array is written as soon as it is added, and the zip central directory
+ * on close(). Archives and members bigger than 4GB use ZIP64 records.
+ *
+ * Arrays are stored without compression when @a level is 0, like numpy's
+ * `savez`, and deflated with that level otherwise, up to 9.
+ *
+ * i.e
+ * ```
+ * np::npz_writer w("file.npz");
+ * w.add("weights", some_array);
+ *
+ * auto m = w.add_stream("log", np::descr_t::make<float>(), {1000, 3});
+ * m.append(some_floats, 10); // 10 rows of 3 floats
+ * ...                        // up to 1000 rows
+ * m.close();
+ *
+ * w.close();
+ * ```
+ */
+class npz_writer
+{
+public:
+    npz_writer(const std::filesystem::path& file, int level = 0);
+    ~npz_writer();
+
+    npz_writer(const npz_writer&) = delete;
+    npz_writer& operator=(const npz_writer&) = delete;
+
+    void add(const std::string& name, const array& a);
+    npz_member_writer add_stream(const std::string& name,
+                                 descr_t descr,
+                                 shape_t shape,
+                                 bool fortran_order = false);
+
+    std::size_t size() const;
+    int level() const;
+    bool is_open() const;
+
+    void close();
+
+private:
+    std::unique_ptr<details::zip_writer> _zip;
+    int                                  _level = 0;
+};
+
+}
+
+#endif // NP_NPZ_WRITER_H
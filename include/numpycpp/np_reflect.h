@@ -0,0 +1,124 @@
+#ifndef NP_REFLECT_H
+#define NP_REFLECT_H
+
+#include "np_descr_t.h"
+#include "np_field_ref.h"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace np
+{
+
+namespace details
+{
+
+/**
+ * @brief Appends the member @a name of type T at @a offset to @a d.
+ */
+template<class T>
+void reflect_field(descr_t& d, const char* name, std::size_t offset)
+{
+    d.push_back(type_t::from_type<T>(), name, offset);
+}
+
+}
+
+}
+
+#define NP_DETAIL_EXPAND(x) x
+
+#define NP_DETAIL_FE_1(F, T, x) F(T, x)
+#define NP_DETAIL_FE_2(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_1(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_3(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_2(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_4(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_3(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_5(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_4(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_6(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_5(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_7(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_6(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_8(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_7(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_9(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_8(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_10(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_9(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_11(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_10(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_12(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_11(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_13(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_12(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_14(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_13(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_15(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_14(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_16(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_15(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_17(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_16(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_18(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_17(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_19(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_18(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_20(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_19(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_21(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_20(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_22(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_21(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_23(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_22(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_24(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_23(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_25(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_24(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_26(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_25(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_27(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_26(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_28(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_27(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_29(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_28(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_30(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_29(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_31(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_30(F, T, __VA_ARGS__))
+#define NP_DETAIL_FE_32(F, T, x, ...) F(T, x) NP_DETAIL_EXPAND(NP_DETAIL_FE_31(F, T, __VA_ARGS__))
+
+#define NP_DETAIL_FE_N(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, N, ...) N
+
+#define NP_DETAIL_FOR_EACH(F, T, ...) \
+    NP_DETAIL_EXPAND(NP_DETAIL_FE_N(__VA_ARGS__, \
+    NP_DETAIL_FE_32, NP_DETAIL_FE_31, NP_DETAIL_FE_30, NP_DETAIL_FE_29, NP_DETAIL_FE_28, NP_DETAIL_FE_27, NP_DETAIL_FE_26, NP_DETAIL_FE_25, \
+    NP_DETAIL_FE_24, NP_DETAIL_FE_23, NP_DETAIL_FE_22, NP_DETAIL_FE_21, NP_DETAIL_FE_20, NP_DETAIL_FE_19, NP_DETAIL_FE_18, NP_DETAIL_FE_17, \
+    NP_DETAIL_FE_16, NP_DETAIL_FE_15, NP_DETAIL_FE_14, NP_DETAIL_FE_13, NP_DETAIL_FE_12, NP_DETAIL_FE_11, NP_DETAIL_FE_10, NP_DETAIL_FE_9, \
+    NP_DETAIL_FE_8, NP_DETAIL_FE_7, NP_DETAIL_FE_6, NP_DETAIL_FE_5, NP_DETAIL_FE_4, NP_DETAIL_FE_3, NP_DETAIL_FE_2, NP_DETAIL_FE_1)(F, T, __VA_ARGS__))
+
+#define NP_DETAIL_REFLECT_FIELD(T, m) \
+    ::np::details::reflect_field<decltype(T::m)>(d, #m, offsetof(T, m));
+
+/**
+ * @brief Specializes np::record_traits for the struct @a T, its fields being
+ * the listed members, up to 32 of them.
+ *
+ * The descr_t gets the offsets of the members and a stride of `sizeof (T)`, the
+ * padding the compiler put between and after them is kept as is. This is the
+ * same layout as a numpy dtype made with `align=True`, so the records can be
+ * copied in and out of an array in one go, see array::from_records() and
+ * array::as_records().
+ *
+ * Use it at global scope, after the struct is defined. The members must be of
+ * a type supported by type_t::from_type().
+ *
+ * i.e
+ * ```
+ * struct Trade
+ * {
+ *     std::int64_t ts;
+ *     float        price;
+ *     std::int32_t qty;
+ *     bool         flag;
+ * };
+ *
+ * NP_REFLECT(Trade, ts, price, qty, flag)
+ *
+ * // [('ts','<i8'),('price','<f4'),('qty','<i4'),('flag','|b1'),('','|V7')]
+ * np::descr_t d = np::record_traits<Trade>::descr();
+ * ```
+ */
+#define NP_REFLECT(T, ...) \
+    namespace np \
+    { \
+    template<> \
+    struct record_traits<T> \
+    { \
+        static_assert(std::is_standard_layout_v<T>, #T " must be standard layout"); \
+        static_assert(std::is_trivially_copyable_v<T>, #T " must be trivially copyable"); \
+        \
+        static descr_t descr() \
+        { \
+            descr_t d; \
+            NP_DETAIL_FOR_EACH(NP_DETAIL_REFLECT_FIELD, T, __VA_ARGS__) \
+            d.set_stride(sizeof (T)); \
+            return d; \
+        } \
+    }; \
+    }
+
+#endif // NP_REFLECT_H
@@ -1,6 +1,13 @@
 #ifndef NP_SHAPE_T_H
 #define NP_SHAPE_T_H
 
+#include "np_error.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
 #include <vector>
 #include <string>
 
@@ -8,13 +15,315 @@ namespace np
 {
 
 /**
- * @brief the shape_t typedef reprensents the shape of the array
+ * @brief the shape_t class reprensents the shape of the array
+ *
+ * It's a vector of dimension sizes as in {d0, d1, d2, ..., dn}, with the
+ * interface of std::vector<std::size_t> that shapes need. Up to inline_capacity
+ * dimensions are stored in the object itself, so making, copying or parsing the
+ * shape of most arrays does not allocate. Bigger shapes fall back to the heap.
  *
- * It's just a vector of dimension sizes as in {d0, d1, d2, ..., dn}
+ * A std::vector converts implicitly to a shape_t and compares equal to it, the
+ * conversion back is explicit, i.e `std::vector<std::size_t>(a.shape())`.
  */
-typedef std::vector<std::size_t> shape_t;
+class shape_t
+{
+public:
+    typedef std::size_t        value_type;
+    typedef std::size_t        size_type;
+    typedef std::ptrdiff_t     difference_type;
+    typedef std::size_t&       reference;
+    typedef const std::size_t& const_reference;
+    typedef std::size_t*       pointer;
+    typedef const std::size_t* const_pointer;
+    typedef std::size_t*       iterator;
+    typedef const std::size_t* const_iterator;
+
+    /// Number of dimensions stored without allocating
+    static constexpr size_type inline_capacity = 8;
+
+public:
+    shape_t() = default;
+
+    explicit shape_t(size_type n) :
+        shape_t(n, 0)
+    {}
+
+    shape_t(size_type n, value_type v)
+    {
+        resize(n, v);
+    }
+
+    shape_t(std::initializer_list<value_type> l) :
+        shape_t(l.begin(), l.end())
+    {}
+
+    template<class It, typename std::enable_if_t<!std::is_integral_v<It>, int> = 0>
+    shape_t(It first, It last)
+    {
+        reserve(static_cast<size_type>(std::distance(first, last)));
+
+        for(; first != last; ++first)
+            push_back(*first);
+    }
+
+    shape_t(const std::vector<value_type>& v) :
+        shape_t(v.begin(), v.end())
+    {}
+
+    shape_t(const shape_t& c) :
+        shape_t(c.begin(), c.end())
+    {}
+
+    shape_t(shape_t&& m) noexcept
+    {
+        *this = std::move(m);
+    }
+
+    ~shape_t()
+    {
+        if(_data != _inline)
+            delete[] _data;
+    }
+
+    shape_t& operator=(const shape_t& c)
+    {
+        if(this != &c)
+        {
+            _size = 0;
+            reserve(c._size);
+            std::copy(c.begin(), c.end(), _data);
+            _size = c._size;
+        }
+
+        return *this;
+    }
+
+    shape_t& operator=(shape_t&& m) noexcept
+    {
+        if(this == &m)
+            return *this;
+
+        if(m._data != m._inline)
+        {
+            if(_data != _inline)
+                delete[] _data;
+
+            _data     = m._data;
+            _capacity = m._capacity;
+            _size     = m._size;
+
+            m._data     = m._inline;
+            m._capacity = inline_capacity;
+        }
+        else
+        {
+            // The inline storage always fits
+            std::copy(m.begin(), m.end(), _data);
+            _size = m._size;
+        }
+
+        m._size = 0;
+
+        return *this;
+    }
+
+    shape_t& operator=(std::initializer_list<value_type> l)
+    {
+        _size = 0;
+        reserve(l.size());
+        std::copy(l.begin(), l.end(), _data);
+        _size = l.size();
+
+        return *this;
+    }
+
+    explicit operator std::vector<value_type>() const
+    {
+        return std::vector<value_type>(begin(), end());
+    }
+
+    inline size_type       size()     const { return _size;         }
+    inline bool            empty()    const { return _size == 0;    }
+    inline size_type       capacity() const { return _capacity;     }
+    inline pointer         data()           { return _data;         }
+    inline const_pointer   data()     const { return _data;         }
+    inline iterator        begin()          { return _data;         }
+    inline const_iterator  begin()    const { return _data;         }
+    inline const_iterator  cbegin()   const { return _data;         }
+    inline iterator        end()            { return _data + _size; }
+    inline const_iterator  end()      const { return _data + _size; }
+    inline const_iterator  cend()     const { return _data + _size; }
+    inline reference       front()          { return _data[0];      }
+    inline const_reference front()    const { return _data[0];      }
+    inline reference       back()           { return _data[_size - 1]; }
+    inline const_reference back()     const { return _data[_size - 1]; }
+
+    inline reference       operator[](size_type i)       { return _data[i]; }
+    inline const_reference operator[](size_type i) const { return _data[i]; }
+
+    /**
+     * @brief Returns the @a i th dimension.
+     * @throw a np::error if @a i is out of range.
+     */
+    const_reference at(size_type i) const
+    {
+        if(i >= _size)
+            throw error("out of range");
+
+        return _data[i];
+    }
+
+    reference at(size_type i)
+    {
+        if(i >= _size)
+            throw error("out of range");
+
+        return _data[i];
+    }
+
+    void reserve(size_type n)
+    {
+        if(n > _capacity)
+            grow(n);
+    }
+
+    void resize(size_type n, value_type v = 0)
+    {
+        reserve(n);
+
+        if(n > _size)
+            std::fill(_data + _size, _data + n, v);
+
+        _size = n;
+    }
+
+    void clear()
+    {
+        _size = 0;
+    }
+
+    void push_back(value_type v)
+    {
+        if(_size == _capacity)
+            grow(_capacity * 2);
+
+        _data[_size++] = v;
+    }
+
+    void pop_back()
+    {
+        --_size;
+    }
+
+    iterator insert(const_iterator pos, value_type v)
+    {
+        size_type i = static_cast<size_type>(pos - _data);
+
+        push_back(v);
+        std::rotate(_data + i, _data + _size - 1, _data + _size);
+
+        return _data + i;
+    }
+
+    template<class It, typename std::enable_if_t<!std::is_integral_v<It>, int> = 0>
+    iterator insert(const_iterator pos, It first, It last)
+    {
+        size_type i = static_cast<size_type>(pos - _data);
+
+        // The range may be in this shape, growing would free it
+        shape_t src(first, last);
+        size_type n = _size;
+
+        reserve(n + src._size);
+        std::copy(src.begin(), src.end(), _data + n);
+        _size = n + src._size;
+
+        std::rotate(_data + i, _data + n, _data + _size);
+
+        return _data + i;
+    }
+
+    void assign(size_type n, value_type v)
+    {
+        clear();
+        resize(n, v);
+    }
+
+    template<class It, typename std::enable_if_t<!std::is_integral_v<It>, int> = 0>
+    void assign(It first, It last)
+    {
+        *this = shape_t(first, last);
+    }
+
+    void assign(std::initializer_list<value_type> l)
+    {
+        *this = l;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        size_type i = static_cast<size_type>(pos - _data);
+
+        std::copy(_data + i + 1, _data + _size, _data + i);
+        --_size;
+
+        return _data + i;
+    }
+
+    void swap(shape_t& o) noexcept
+    {
+        shape_t tmp(std::move(o));
+        o = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    bool operator==(const shape_t& o) const
+    {
+        return std::equal(begin(), end(), o.begin(), o.end());
+    }
+
+    bool operator!=(const shape_t& o) const
+    {
+        return !(*this == o);
+    }
+
+private:
+    void grow(size_type n);
+
+private:
+    size_type* _data     = _inline;
+    size_type  _size     = 0;
+    size_type  _capacity = inline_capacity;
+    size_type  _inline[inline_capacity];
+};
+
+inline void swap(shape_t& a, shape_t& b) noexcept
+{
+    a.swap(b);
+}
+
+inline bool operator==(const shape_t& a, const std::vector<std::size_t>& b)
+{
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
+}
+
+inline bool operator==(const std::vector<std::size_t>& a, const shape_t& b)
+{
+    return b == a;
+}
+
+inline bool operator!=(const shape_t& a, const std::vector<std::size_t>& b)
+{
+    return !(a == b);
+}
+
+inline bool operator!=(const std::vector<std::size_t>& a, const shape_t& b)
+{
+    return !(b == a);
+}
 
 std::string shape_to_string(const shape_t& shape);
+shape_t element_strides(const shape_t& shape, bool fortran_order);
 
 
 /**
@@ -3,6 +3,7 @@
 
 #include <typeindex>
 #include <string>
+#include <string_view>
 
 #include "np_bytes_utils.h"
 
@@ -41,7 +42,7 @@ public:
                 && (!check_endianness || _endianness == NativeEndian);
     }
 
-    static type_t from_string(const std::string& str);
+    static type_t from_string(std::string_view str);
 
     /**
      * @brief make a new type_t from c++ T and optionnal @a endianness
@@ -0,0 +1,128 @@
+#ifndef NP_TYPED_VIEW_H
+#define NP_TYPED_VIEW_H
+
+#include "np_error.h"
+#include "np_shape_t.h"
+
+#include <cstddef>
+
+namespace np
+{
+
+/**
+ * @brief The typed_view class gives direct access to the elements of an array
+ * of a single type T, see array::as().
+ *
+ * The type is checked once when the view is made, accessing an element is
+ * then plain pointer arithmetic. The elements are contiguous, begin() and end()
+ * are raw pointers walking them in memory order.
+ *
+ * The view does not own the data, it must not outlive its array.
+ *
+ * i.e
+ * ```
+ * auto v = a.as<double>();
+ *
+ * for(double& d : v)
+ *     d *= 2;
+ *
+ * double x = v(1, 2, 3);
+ * ```
+ */
+template<class T>
+class typed_view
+{
+public:
+    typedef T           value_type;
+    typedef T&          reference;
+    typedef T*          pointer;
+    typedef T*          iterator;
+    typedef std::size_t size_type;
+
+public:
+    typed_view() = default;
+
+    /**
+     * @brief Views the @a data of an array of @a shape, in Fortran order if
+     * @a fortran_order.
+     */
+    typed_view(T* data, const shape_t& shape, bool fortran_order) :
+        _data(data),
+        _shape(shape),
+        _strides(element_strides(shape, fortran_order))
+    {
+        std::size_t s = 1;
+
+        for(auto d : _shape)
+            s *= d;
+
+        _size = _shape.empty() ? 0 : s;
+    }
+
+    /**
+     * @brief Returns the element at the coordinates @a args, without any check.
+     *
+     * i.e `v(1, 2, 3)`
+     */
+    template<class... Args>
+    T& operator()(Args... args) const
+    {
+        std::size_t coords[] = {static_cast<std::size_t>(args)...};
+        std::size_t idx = 0;
+
+        for(std::size_t k = 0; k < sizeof... (Args); k++)
+            idx += coords[k] * _strides[k];
+
+        return _data[idx];
+    }
+
+    /**
+     * @brief Returns the element at the coordinates @a args.
+     * @throw a np::error if the coordinates don't match the shape.
+     */
+    template<class... Args>
+    T& at(Args... args) const
+    {
+        std::size_t coords[] = {static_cast<std::size_t>(args)...};
+
+        if(sizeof... (Args) != _shape.size())
+            throw error("size does not match");
+
+        for(std::size_t k = 0; k < sizeof... (Args); k++)
+        {
+            if(coords[k] >= _shape[k])
+                throw error("out of range");
+        }
+
+        return (*this)(args...);
+    }
+
+    /**
+     * @brief Returns the @a i th element in memory order, without any check.
+     */
+    T& operator[](std::size_t i) const { return _data[i]; }
+
+    inline T*             data()       const { return _data;          }
+    inline T*             begin()      const { return _data;          }
+    inline T*             end()        const { return _data + _size;  }
+    inline std::size_t    size()       const { return _size;          }
+    inline bool           empty()      const { return _size == 0;     }
+    inline std::size_t    dimensions() const { return _shape.size();  }
+    inline const shape_t& shape()      const { return _shape;         }
+
+    /**
+     * @brief Returns the distance between 2 consecutive elements along each
+     * axis, in elements.
+     */
+    inline const shape_t& strides() const { return _strides; }
+
+private:
+    T*          _data = nullptr;
+    std::size_t _size = 0;
+    shape_t     _shape;
+    shape_t     _strides;
+};
+
+}
+
+#endif // NP_TYPED_VIEW_H
@@ -2,5 +2,10 @@
 #define NUMPYCPP_H
 
 #include "np_array.h"
+#include "np_npy_reader.h"
+#include "np_npy_writer.h"
+#include "np_npz_archive.h"
+#include "np_npz_writer.h"
+#include "np_reflect.h"
 
 #endif // NUMPYCPP_H
@@ -1,4 +1,7 @@
 # my_library-config.cmake - package configuration file
 
+include(CMakeFindDependencyMacro)
+find_dependency(Threads)
+
 get_filename_component(SELF_DIR "${CMAKE_CURRENT_LIST_FILE}" PATH)
 include(${SELF_DIR}/numpycpp.cmake)
\ No newline at end of file
@@ -1,15 +1,38 @@
 #include <numpycpp/np_array.h>
 #include <numpycpp/np_error.h>
 
-namespace fs = std::filesystem;
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 
-#include <zip_file.hpp>
+namespace fs = std::filesystem;
 
 namespace np
 {
 
+/**
+ * @brief Constructs an empty array which will allocate its data from @a mr.
+ */
+array::array(std::pmr::memory_resource* mr) :
+    _resource(mr)
+{
+    if(!_resource)
+        throw error("null memory resource");
+}
+
 /**
  * @brief Copy ctor
+ *
+ * The copy allocates its data from the default memory resource, as pmr
+ * containers do.
+ *
  * @param c another array.
  */
 array::array(const array& c) :
@@ -18,35 +41,65 @@ array::array(const array& c) :
     *this = c;
 }
 
+/**
+ * @brief Copy ctor allocating the copied data from @a mr.
+ * @param c another array.
+ */
+array::array(const array& c, std::pmr::memory_resource* mr) :
+    array(mr)
+{
+    *this = c;
+}
+
 /**
  * @brief Move ctor
  * @param m another array.
  */
-array::array(array&& m) :
+array::array(array&& m) noexcept :
     array()
 {
     swap(m);
 }
 
 /**
- * @brief Constructs an array with the given property.
+ * @brief Constructs an array with the given property, filled with zeros.
+ *
+ * @param d The structure descriptor.
+ * @param s The dimension shape.
+ * @param f Wether the array is in Fortran order.
+ * @param mr The memory resource to allocate the data from.
+ */
+array::array(descr_t d, shape_t s, bool f, std::pmr::memory_resource* mr) :
+    array(uninitialized, std::move(d), std::move(s), f, mr)
+{
+    if(_data)
+        std::memset(_data, 0, data_size());
+}
+
+/**
+ * @brief Constructs an array with the given property without initializing
+ * its data.
+ *
+ * This is what the load functions use since the data is overwritten right
+ * away, and what you want if you are about to fill the whole array anyway.
  *
  * @param d The structure descriptor.
  * @param s The dimension shape.
  * @param f Wether the array is in Fortran order.
+ * @param mr The memory resource to allocate the data from.
  */
-array::array(descr_t d, shape_t s, bool f) :
+array::array(uninitialized_t, descr_t d, shape_t s, bool f, std::pmr::memory_resource* mr) :
     _data(nullptr),
-    _shape(s),
-    _descr(d),
-    _fortran_order(f)
+    _shape(std::move(s)),
+    _strides(element_strides(_shape, f)),
+    _descr(std::move(d)),
+    _fortran_order(f),
+    _resource(mr)
 {
-    std::size_t size = data_size();
-    if(size > 0)
-    {
-        _data = new char[size];
-        std::memset(_data, 0, size);
-    }
+    if(!_resource)
+        throw error("null memory resource");
+
+    _data = allocate(data_size());
 }
 
 /**
@@ -54,39 +107,57 @@ array::array(descr_t d, shape_t s, bool f) :
  */
 array::~array()
 {
-    if(_data)
-        delete[] _data;
+    release();
 }
 
 /**
  * @brief Copy assignment.
+ *
+ * The data is copied in a buffer allocated from the memory resource of this
+ * array.
  */
 array& array::operator =(const array& c)
 {
-    if(_data)
-        delete[] _data;
+    if(this == &c)
+        return *this;
+
+    release();
 
     _shape         = c._shape;
+    _strides       = c._strides;
     _descr         = c._descr;
     _fortran_order = c._fortran_order;
 
-    std::size_t size = data_size();
-    if(size > 0)
+    // Mapped arrays share their mapping instead of copying the data
+    if(c._mapping)
     {
-        _data = new char[size];
-        std::memcpy(_data, c._data, size);
+        _mapping = c._mapping;
+        _data    = c._data;
+        return *this;
     }
-    else
-        _data = nullptr;
+
+    std::size_t size = data_size();
+
+    _data = allocate(size);
+
+    if(_data)
+        std::memcpy(_data, c._data, size);
 
     return *this;
 }
 
 /**
  * @brief Move assignment.
+ *
+ * The data is only stolen if both arrays use the same memory resource,
+ * otherwise it is copied in a buffer allocated from the memory resource of
+ * this array.
  */
 array& array::operator =(array&& m)
 {
+    if(m._mapping || !(_resource == m._resource || _resource->is_equal(*m._resource)))
+        return *this = static_cast<const array&>(m);
+
     swap(m);
     return *this;
 }
@@ -101,14 +172,28 @@ bool array::empty() const
 
 /**
  * @brief Swap the content of 2 arrays.
+ *
+ * The memory resources are swapped along with the data they allocated.
+ *
  * @param o another array.
  */
 void array::swap(array& o)
 {
     _shape.swap(o._shape);
+    _strides.swap(o._strides);
     _descr.swap(o._descr);
     std::swap(_fortran_order, o._fortran_order);
     std::swap(_data, o._data);
+    _mapping.swap(o._mapping);
+    std::swap(_resource, o._resource);
+}
+
+/**
+ * @brief Returns the memory resource the data is allocated from.
+ */
+std::pmr::memory_resource* array::resource() const
+{
+    return _resource;
 }
 
 /**
@@ -196,6 +281,41 @@ const type_t& array::type(const std::string& field) const
     return _descr[field];
 }
 
+/**
+ * @brief Throws a np::error if the data is mapped read only.
+ */
+void array::check_writable() const
+{
+    if(_mapping && _mapping->mode() == ReadOnly)
+        throw error("the array is mapped read only");
+}
+
+/**
+ * @brief Throws a np::error unless the elements are laid out as described by
+ * @a layout in native endianness, in records of @a size bytes.
+ *
+ * Only names, C++ types and offsets are compared, so a descriptor read from a
+ * file matches the one made from C++ types.
+ */
+void array::check_record_layout(const descr_t& layout, std::size_t size) const
+{
+    if(_descr.stride() != size || layout.stride() != size || _descr.size() != layout.size())
+        throw error("record layout does not match");
+
+    for(std::size_t i = 0; i < layout.size(); i++)
+    {
+        const field_t& a = _descr[i];
+        const field_t& b = layout[i];
+
+        if(a.first != b.first
+           || a.second.index()  != b.second.index()
+           || a.second.size()   != b.second.size()
+           || a.second.offset() != b.second.offset()
+           || (a.second.size() > 1 && a.second.endianness() != NativeEndian))
+            throw error("record layout does not match: " + a.first);
+    }
+}
+
 /**
  * @brief Wether the array is in fortran order.
  */
@@ -217,10 +337,10 @@ const char* array::data() const
 }
 
 /**
- * @brief Loads the given npy @a file.
+ * @brief Loads the given npy @a file, its data is allocated from @a mr.
  * @throw a np::error on failure.
  */
-array array::load(const fs::path& file)
+array array::load(const fs::path& file, std::pmr::memory_resource* mr)
 {
     auto f = std::fopen(file.string().c_str(), "rb");
 
@@ -229,317 +349,1178 @@ array array::load(const fs::path& file)
 
     finally cleanup([f](){ std::fclose(f); });
 
-    return load(f);
+    return load(f, mr);
 }
 
 /**
- * @brief Load the numpy data from the given @a strem
+ * @brief Load the numpy data from the given @a strem, its data is allocated
+ * from @a mr.
  * @throw a np::error on failure.
  */
-array array::load(std::istream& stream)
+array array::load(std::istream& stream, std::pmr::memory_resource* mr)
 {
-    return load<stream_reader>(stream);
+    return load<stream_reader>(stream, mr);
 }
 
 /**
- * @brief loads numpy data from the given @a file
+ * @brief loads numpy data from the given @a file, its data is allocated from
+ * @a mr.
  */
-array array::load(std::FILE* file)
+array array::load(std::FILE* file, std::pmr::memory_resource* mr)
 {
-    return load<file_io>(file);
+    return load<file_io>(file, mr);
 }
 
 /**
- * @brief Saves the current array into @a file.
+ * @brief Loads the numpy data from the given @a file according to @a options,
+ * its data is allocated from @a mr.
+ * @see load(Handle&, const load_options&, std::pmr::memory_resource*)
  * @throw a np::error on failure.
  */
-void array::save(const fs::path& file) const
+array array::load(const fs::path& file, const load_options& options, std::pmr::memory_resource* mr)
 {
-    auto f = std::fopen(file.string().c_str(), "wb");
+    auto f = std::fopen(file.string().c_str(), "rb");
 
     if(!f)
         throw error("unable to open file");
 
     finally cleanup([f](){ std::fclose(f); });
 
-    save(f);
-}
-
-/**
- * @brief Saves the current array into the given @a stream.
- * @throw a np::error on failure
- */
-void array::save(std::ostream& stream) const
-{
-    save<stream_writer>(stream);
+    return load(f, options, mr);
 }
 
 /**
- * @brief Saves the current array into the given @a stream.
- * @throw a np::error on failure
+ * @brief Loads the numpy data from the given @a stream according to
+ * @a options, its data is allocated from @a mr.
+ * @throw a np::error on failure.
  */
-void array::save(FILE* file) const
+array array::load(std::istream& stream, const load_options& options, std::pmr::memory_resource* mr)
 {
-    save<file_io>(file);
+    return load<stream_reader>(stream, options, mr);
 }
 
 /**
- * @brief Returns the string header of the current array.
+ * @brief Loads the numpy data from the given @a file according to @a options,
+ * its data is allocated from @a mr.
+ * @throw a np::error on failure.
  */
-std::string array::header() const
+array array::load(std::FILE* file, const load_options& options, std::pmr::memory_resource* mr)
 {
-    return "{"
-           "'descr': " + _descr.to_string() + ", "
-           "'fortran_order': " + std::string(_fortran_order ? "True" : "False") + ", "
-           "'shape': " + shape_to_string(_shape) +
-           "}";
+    return load<file_io>(file, options, mr);
 }
 
 /**
- * @brief Swap the bytes of the array in respect of @a e.
+ * @brief Loads @a count rows starting at @a first from the given npy @a file.
+ * @see load_rows(Handle&, std::size_t, std::size_t, std::pmr::memory_resource*)
+ * @throw a np::error on failure.
  */
-void array::convert_to(Endianness e)
+array array::load_rows(const fs::path& file,
+                       std::size_t first,
+                       std::size_t count,
+                       std::pmr::memory_resource* mr)
 {
-    for(auto it : *this)
-    {
-        for(auto& field : _descr._fields)
-        {
-            auto& type = field.second;
-
-            if(type._endianness != e)
-            {
-                byte_swap(it.ptr(field.first), type._size);
-                type._endianness = e;
-            }
-        }
-    }
-}
-
-//void array::transpose_order()
-//{
-//    if(dimensions() <= 1)
-//        return;
-
-//    array tmp(_descr, _shape, !_fortran_order);
-
-//    std::size_t s = _descr.stride;
-
-//    std::vector<std::size_t> indices(dimensions(), 0);
-//    std::size_t idx = index(indices);
-//    std::size_t oidx = tmp.index(indices);
-
-//    do
-//    {
-//        std::memcpy(at(idx).ptr(), tmp.at(oidx).ptr(), s);
-
-//        for(std::size_t d = 0; d < dimensions(); d++)
-//        {
-//            indices[d]++;
+    auto f = std::fopen(file.string().c_str(), "rb");
 
-//            if(indices[d] >= _shape[d])
-//                indices[d] = 0;
-//            else
-//                break;
-//        }
+    if(!f)
+        throw error("unable to open file");
 
-//        idx = index(indices);
-//        oidx = tmp.index(indices);
-//    } while(indices != std::vector<std::size_t>{0, 0, 0});
+    finally cleanup([f](){ std::fclose(f); });
 
-//    swap(tmp);
-//}
+    return load_rows(f, first, count, mr);
+}
 
 /**
- * @brief Returns an iterator pointing to the first element.
+ * @brief Loads @a count rows starting at @a first from the given @a stream.
+ * @throw a np::error on failure.
  */
-array::iterator array::begin()
+array array::load_rows(std::istream& stream,
+                       std::size_t first,
+                       std::size_t count,
+                       std::pmr::memory_resource* mr)
 {
-    iterator it;
-    it._array = this;
-    it._data = _data;
-
-    return it;
+    return load_rows<stream_reader>(stream, first, count, mr);
 }
 
 /**
- * @brief Returns a constant iterator pointing to the first element.
+ * @brief Loads @a count rows starting at @a first from the given @a file.
+ * @throw a np::error on failure.
  */
-array::const_iterator array::begin() const
+array array::load_rows(std::FILE* file,
+                       std::size_t first,
+                       std::size_t count,
+                       std::pmr::memory_resource* mr)
 {
-    return cbegin();
+    return load_rows<file_io>(file, first, count, mr);
 }
 
 /**
- * @brief Returns a constant iterator pointing to the first element.
+ * @brief Loads the hyperslab of size @a extent starting at @a start from the
+ * given npy @a file.
+ * @see load_slice(Handle&, const shape_t&, const shape_t&, std::pmr::memory_resource*)
+ * @throw a np::error on failure.
  */
-array::const_iterator array::cbegin() const
+array array::load_slice(const fs::path& file,
+                        const shape_t& start,
+                        const shape_t& extent,
+                        std::pmr::memory_resource* mr)
 {
-    iterator it;
-    it._array = const_cast<array*>(this);
-    it._data = _data;
+    auto f = std::fopen(file.string().c_str(), "rb");
 
-    return it;
-}
+    if(!f)
+        throw error("unable to open file");
 
-/**
- * @brief Returns an iterator pointing past the last element.
- */
-array::iterator array::end()
-{
-    iterator it;
-    it._array = this;
-    it._data = _data + data_size();
+    finally cleanup([f](){ std::fclose(f); });
 
-    return it;
+    return load_slice(f, start, extent, mr);
 }
 
 /**
- * @brief Returns a constant iterator pointing past the last element.
+ * @brief Loads the hyperslab of size @a extent starting at @a start from the
+ * given @a stream.
+ * @throw a np::error on failure.
  */
-array::const_iterator array::end() const
+array array::load_slice(std::istream& stream,
+                        const shape_t& start,
+                        const shape_t& extent,
+                        std::pmr::memory_resource* mr)
 {
-    return cend();
+    return load_slice<stream_reader>(stream, start, extent, mr);
 }
 
 /**
- * @brief Returns a constant iterator pointing past the last element.
+ * @brief Loads the hyperslab of size @a extent starting at @a start from the
+ * given @a file.
+ * @throw a np::error on failure.
  */
-array::const_iterator array::cend() const
+array array::load_slice(std::FILE* file,
+                        const shape_t& start,
+                        const shape_t& extent,
+                        std::pmr::memory_resource* mr)
 {
-    const_iterator it;
-    it._array = const_cast<array*>(this);
-    it._data = _data + data_size();
-
-    return it;
+    return load_slice<file_io>(file, start, extent, mr);
 }
 
 /**
- * @brief Returns an iterator pointing at the element at @a index
+ * @brief Maps the given npy @a file in memory instead of reading it.
+ *
+ * The header is parsed in place and the array data points directly into the
+ * mapping, nothing is allocated nor copied. The mapping is shared between the
+ * copies of the returned array and released with the last one.
+ *
+ * Depending on @a mode, writing to the array is either forbidden (ReadOnly),
+ * kept private to the process (CopyOnWrite) or written back to the file
+ * (ReadWrite).
+ *
+ * In ReadOnly mode, convert_to(), to_c_order() and to_fortran_order() throw a
+ * np::error, and writing through the element accessors (operator[], at(),
+ * as(), field(), ...) is undefined behaviour, it usually crashes.
+ *
+ * @throw a np::error on failure.
  */
-array::iterator array::operator[](std::size_t index)
+array array::map(const fs::path& file, MapMode mode)
 {
-    return at_index(index);
+    auto mapping = std::make_shared<mapped_file>(file, mode);
+    std::size_t size = mapping->size();
+
+    return map(std::move(mapping), 0, size);
 }
 
 /**
- * @brief Returns a constant iterator pointing at the element at @a index
+ * @brief Parses the npy file found at @a offset in @a mapping, spanning
+ * @a size bytes, and returns an array pointing into the mapping.
+ * @throw a np::error on failure.
  */
-array::const_iterator array::operator[](std::size_t index) const
+array array::map(std::shared_ptr<mapped_file> mapping,
+                 std::size_t offset,
+                 std::size_t size)
 {
-    return at_index(index);
+    if(offset > mapping->size() || size > mapping->size() - offset)
+        throw error("npy data out of the mapped file");
+
+    memory_reader io(mapping->data() + offset, size);
+
+    header_info info = read_header(io);
+
+    array a;
+    a._descr         = std::move(info.descr);
+    a._shape         = std::move(info.shape);
+    a._strides       = element_strides(a._shape, info.fortran_order);
+    a._fortran_order = info.fortran_order;
+
+    std::size_t available = io.available();
+    std::size_t expected = a.data_size();
+
+    if(available != expected)
+        throw error("error while reading file. "
+                    "only " + std::to_string(available) + "bytes available "
+                    "where " + std::to_string(expected) + "bytes were expected");
+
+    if(expected > 0)
+    {
+        a._data    = mapping->data() + offset + info.data_offset;
+        a._mapping = std::move(mapping);
+    }
+
+    return a;
 }
 
 /**
- * @brief Returns an iterator pointing at the element at @a index
+ * @brief Returns wether the array data lives in a memory mapped file.
  */
-array::iterator array::at_index(std::size_t index)
+bool array::mapped() const
 {
-    if(index >= size())
-        throw error("out of range");
-
-    iterator it;
-    it._array = this;
-    it._data = _data + index * _descr.stride();
-
-    return it;
+    return static_cast<bool>(_mapping);
 }
 
 /**
- * @brief Returns a constant iterator pointing at the element at @a index
+ * @brief Reads the header of the given npy @a file and nothing else.
+ * @throw a np::error on failure.
  */
-array::const_iterator array::at_index(std::size_t index) const
+header_info array::inspect(const fs::path& file)
 {
-    if(index >= size())
-        throw error("out of range");
+    auto f = std::fopen(file.string().c_str(), "rb");
 
-    const_iterator it;
-    it._array = const_cast<array*>(this);
-    it._data = _data + index * _descr.stride();
+    if(!f)
+        throw error("unable to open file");
 
-    return it;
+    finally cleanup([f](){ std::fclose(f); });
+
+    return inspect(f);
 }
 
 /**
- * @brief Returns an iterator pointing to the coordinates @a indices
+ * @brief Reads the header from the given @a stream and nothing else.
+ * @throw a np::error on failure.
  */
-array::iterator array::at(std::vector<std::size_t> indices)
+header_info array::inspect(std::istream& stream)
 {
-    return at(index(indices));
+    return inspect<stream_reader>(stream);
 }
 
 /**
- * @brief Returns a constant iterator pointing to the coordinates @a indices
+ * @brief Reads the header from the given @a file and nothing else.
+ * @throw a np::error on failure.
  */
-array::const_iterator array::at(std::vector<std::size_t> indices) const
+header_info array::inspect(std::FILE* file)
 {
-    return at(index(indices));
+    return inspect<file_io>(file);
 }
 
 /**
- * @brief Returns the index of the element at coordinates @a indices
+ * @brief Reads the headers of all the npy files in @a dir, in parallel.
+ *
+ * The files are probed by a pool of @a max_open_files threads, each of them
+ * holding at most one file open at a time. 0 means one thread per core.
+ *
+ * If @a errors is given, the files that can't be read are reported there along
+ * with the reason and the probing goes on, otherwise the first error is thrown
+ * once every thread is done.
+ *
+ * @return the headers sorted by file name.
+ * @throw a np::error on failure.
  */
-std::size_t array::index(std::vector<std::size_t> indices) const
+std::vector<std::pair<fs::path, header_info>>
+array::inspect_directory(const fs::path& dir,
+                         std::size_t max_open_files,
+                         std::vector<std::pair<fs::path, std::string>>* errors)
 {
-    if(indices.size() < _shape.size())
-        throw error("size does not match");
-
-    std::size_t idx = 0;
+    std::vector<fs::path> files;
 
-    if(_fortran_order)
+    for(auto& e : fs::directory_iterator(dir))
     {
-        std::size_t k = 0;
-
-        for(auto& nk : indices)
-            idx += index_f_order(_shape, k++, nk);
+        if(e.is_regular_file() && e.path().extension() == ".npy")
+            files.push_back(e.path());
     }
-    else
-    {
-        std::size_t k = 0;
 
-        for(auto& nk : indices)
-            idx += index_c_order(_shape, k++, nk);
-    }
+    std::sort(files.begin(), files.end());
 
-    return idx;
-}
+    if(max_open_files == 0)
+        max_open_files = std::max(1u, std::thread::hardware_concurrency());
 
-/**
- * @brief Returns the size of the underlying data blob.
- */
-std::size_t array::data_size() const
-{
-    return size() * _descr.stride();
-}
+    max_open_files = std::min(max_open_files, files.size());
 
+    std::vector<header_info> infos(files.size());
+    std::vector<std::string> failures(files.size());
+    std::vector<char> failed(files.size(), false);
+    std::atomic<std::size_t> next(0);
 
+    auto worker = [&]()
+    {
+        for(std::size_t i = next++; i < files.size(); i = next++)
+        {
+            try
+            {
+                infos[i] = inspect(files[i]);
+            }
+            catch(std::exception& e)
+            {
+                failures[i] = e.what();
+                failed[i] = true;
+            }
+        }
+    };
 
-// ====== Utilities ============================================================
+    std::vector<std::thread> threads;
 
+    for(std::size_t t = 1; t < max_open_files; t++)
+        threads.emplace_back(worker);
 
+    worker();
 
-stream_reader::stream_reader(std::istream& stream) :
-    stream(stream)
-{
-    if(!stream)
-        throw error("input stream in fail state");
-}
+    for(auto& t : threads)
+        t.join();
 
-void stream_reader::read(void *ptr, std::size_t size)
-{
-    stream.read(reinterpret_cast<char*>(ptr), size);
+    std::vector<std::pair<fs::path, header_info>> r;
+    r.reserve(files.size());
 
-    if(size != stream.gcount())
-        throw error("error while reading input stream: "
-                    "only " + std::to_string(stream.gcount()) + " byte(s) read "
-                    "where " + std::to_string(size) + " byte(s) were expected");
+    for(std::size_t i = 0; i < files.size(); i++)
+    {
+        if(!failed[i])
+            r.emplace_back(std::move(files[i]), std::move(infos[i]));
+        else if(errors)
+            errors->emplace_back(std::move(files[i]), std::move(failures[i]));
+        else
+            throw error(files[i].string() + " - " + failures[i]);
+    }
 
-    if(!stream)
-        throw error("error while reading input stream");
+    return r;
 }
 
-std::size_t stream_reader::available()
-{
-    auto data_start = stream.tellg();
+/**
+ * @brief Saves the current array into @a file.
+ * @throw a np::error on failure.
+ */
+void array::save(const fs::path& file) const
+{
+    auto f = std::fopen(file.string().c_str(), "wb");
+
+    if(!f)
+        throw error("unable to open file");
+
+    finally cleanup([f](){ std::fclose(f); });
+
+    save(f);
+}
+
+/**
+ * @brief Saves the current array into the given @a stream.
+ * @throw a np::error on failure
+ */
+void array::save(std::ostream& stream) const
+{
+    save<stream_writer>(stream);
+}
+
+/**
+ * @brief Saves the current array into the given @a stream.
+ * @throw a np::error on failure
+ */
+void array::save(FILE* file) const
+{
+    save<file_io>(file);
+}
+
+/**
+ * @brief Returns the string header of the current array.
+ */
+std::string array::header() const
+{
+    return make_header(_descr, _shape, _fortran_order);
+}
+
+/**
+ * @brief Returns the string header of an array described by @a descr, @a shape
+ * and @a fortran_order.
+ */
+std::string array::make_header(const descr_t& descr, const shape_t& shape, bool fortran_order)
+{
+    return "{"
+           "'descr': " + descr.to_string() + ", "
+           "'fortran_order': " + std::string(fortran_order ? "True" : "False") + ", "
+           "'shape': " + shape_to_string(shape) +
+           "}";
+}
+
+/**
+ * @brief Returns everything written before the data in a npy file: the magic
+ * string, the version, the header length and the header, padded so the data
+ * is 64 bytes aligned.
+ */
+std::string array::make_preamble(const descr_t& descr, const shape_t& shape, bool fortran_order)
+{
+    std::string header_str = make_header(descr, shape, fortran_order);
+
+    // magic + version + len + header
+    while((6 + 2 + 4 + header_str.length()) % 64 != 0)
+        header_str.push_back(' ');
+
+    std::uint32_t len = static_cast<std::uint32_t>(header_str.length());
+    len = byte_swap(len, NativeEndian, LittleEndian);
+
+    std::string preamble("\x93NUMPY\x02\x00", 8);
+    preamble.append(reinterpret_cast<const char*>(&len), 4);
+    preamble += header_str;
+
+    return preamble;
+}
+
+/**
+ * @brief Swap the bytes of the array in respect of @a e.
+ */
+void array::convert_to(Endianness e)
+{
+    check_writable();
+
+    if(!empty())
+        swap_elements(_descr, _data, size(), e);
+
+    for(auto& field : _descr._fields)
+        field.second._endianness = e;
+}
+
+/**
+ * @brief Swaps the bytes of the fields of the @a count elements described by
+ * @a descr at @a data whose endianness is not @a e. The descriptor itself is
+ * left untouched.
+ *
+ * Each field is swapped at once over all the elements: in a single contiguous
+ * run when it is the only one, or every stride bytes otherwise.
+ */
+void array::swap_elements(const descr_t& descr,
+                          char* data,
+                          std::size_t count,
+                          Endianness e)
+{
+    std::size_t stride = descr._stride;
+
+    for(auto& field : descr._fields)
+    {
+        auto& type = field.second;
+
+        if(type._endianness == e)
+            continue;
+
+        // Strings are made of 4 bytes characters and complex of 2 floats
+        std::size_t width = type._size;
+
+        if(type._ptype == 'U')
+            width = sizeof (char32_t);
+        else if(type._ptype == 'c')
+            width = type._size / 2;
+
+        std::size_t values = width == 0 ? 0 : type._size / width;
+        char* ptr = data + type._offset;
+
+        if(type._size == stride)
+            byte_swap(ptr, width, count * values);
+        else if(values == 1)
+            byte_swap(ptr, width, count, stride);
+        else
+        {
+            for(std::size_t i = 0; i < count; i++)
+                byte_swap(ptr + i * stride, width, values);
+        }
+    }
+}
+
+/**
+ * @brief Gives the array a new @a shape with the same number of elements.
+ *
+ * Only the shape changes, the data is neither moved nor copied. The elements
+ * keep their position in memory and are read in the order of the array, which
+ * is C order or Fortran order, as numpy does with `order='A'`.
+ *
+ * i.e `a.reshape({1024, 3, 224, 224});`
+ *
+ * @throw a np::error if the number of elements does not match.
+ */
+void array::reshape(shape_t shape)
+{
+    std::size_t n = shape.empty() ? 0 : 1;
+
+    for(auto d : shape)
+        n *= d;
+
+    if(n != size())
+        throw error("cannot reshape array of size " + std::to_string(size()) +
+                    " into shape " + shape_to_string(shape));
+
+    set_shape(std::move(shape));
+}
+
+/**
+ * @brief Removes the axes of size 1, the data is untouched.
+ *
+ * An array of a single element keeps one axis, since an array with no
+ * dimension is empty.
+ */
+void array::squeeze()
+{
+    if(_shape.empty())
+        return;
+
+    shape_t shape;
+
+    for(auto d : _shape)
+    {
+        if(d != 1)
+            shape.push_back(d);
+    }
+
+    if(shape.empty())
+        shape.push_back(1);
+
+    set_shape(std::move(shape));
+}
+
+/**
+ * @brief Removes the @a axis, of size 1, the data is untouched.
+ * @throw a np::error if @a axis is out of range or not of size 1.
+ */
+void array::squeeze(std::size_t axis)
+{
+    if(axis >= _shape.size())
+        throw error("out of range");
+
+    if(_shape[axis] != 1 || _shape.size() == 1)
+        throw error("cannot squeeze an axis of size " + std::to_string(_shape[axis]));
+
+    shape_t shape = _shape;
+    shape.erase(shape.begin() + axis);
+
+    set_shape(std::move(shape));
+}
+
+/**
+ * @brief Inserts an axis of size 1 at position @a axis, the data is
+ * untouched.
+ *
+ * i.e a {3, 4} array is {3, 1, 4} after `a.expand_dims(1)`
+ *
+ * @throw a np::error if @a axis is greater than the number of dimensions or
+ * the array has no dimension.
+ */
+void array::expand_dims(std::size_t axis)
+{
+    if(_shape.empty())
+        throw error("cannot expand an array with no dimension");
+
+    if(axis > _shape.size())
+        throw error("out of range");
+
+    shape_t shape = _shape;
+    shape.insert(shape.begin() + axis, 1);
+
+    set_shape(std::move(shape));
+}
+
+/**
+ * @brief Makes the array 1 dimension, the elements in the order of the array.
+ * The data is untouched.
+ */
+void array::ravel()
+{
+    if(_shape.empty())
+        return;
+
+    set_shape({size()});
+}
+
+/**
+ * @brief Replaces the shape and the element strides, the size is unchanged.
+ */
+void array::set_shape(shape_t shape)
+{
+    _strides = element_strides(shape, _fortran_order);
+    _shape   = std::move(shape);
+}
+
+/**
+ * @brief Rearranges the data in C order, the shape and the values at each
+ * coordinates are unchanged.
+ *
+ * The elements are copied by tiles small enough to stay in cache, using
+ * @a threads threads, 0 meaning one per core.
+ */
+void array::to_c_order(std::size_t threads)
+{
+    set_order(false, threads);
+}
+
+/**
+ * @brief Rearranges the data in Fortran order, the shape and the values at
+ * each coordinates are unchanged.
+ * @see to_c_order()
+ */
+void array::to_fortran_order(std::size_t threads)
+{
+    set_order(true, threads);
+}
+
+/**
+ * @brief Returns a copy of the array with its axes permuted, the axis d of
+ * the result being the axis @a axes [d] of this one. The axes are reversed if
+ * @a axes is empty, as numpy does.
+ *
+ * The result is in the same order as this array. The elements are copied by
+ * tiles small enough to stay in cache, using @a threads threads, 0 meaning one
+ * per core.
+ *
+ * i.e `np::array t = a.transpose({1, 0, 2});`
+ *
+ * @throw a np::error if @a axes is not a permutation of the axes.
+ */
+array array::transpose(const std::vector<std::size_t>& axes, std::size_t threads) const
+{
+    std::size_t n = _shape.size();
+    std::vector<std::size_t> perm = axes;
+
+    if(perm.empty())
+    {
+        for(std::size_t d = 0; d < n; d++)
+            perm.push_back(n - 1 - d);
+    }
+
+    if(perm.size() != n)
+        throw error("size does not match");
+
+    std::vector<char> seen(n, false);
+
+    for(auto d : perm)
+    {
+        if(d >= n || seen[d])
+            throw error("axes are not a permutation");
+
+        seen[d] = true;
+    }
+
+    auto strides = byte_strides();
+
+    shape_t shape(n);
+    std::vector<std::ptrdiff_t> src_strides(n);
+
+    for(std::size_t d = 0; d < n; d++)
+    {
+        shape[d]       = _shape[perm[d]];
+        src_strides[d] = strides[perm[d]];
+    }
+
+    array r(uninitialized, _descr, shape, _fortran_order, _resource);
+
+    if(r.data_size() > 0)
+        permute_copy(_data, src_strides, r._data, _descr.stride(), shape, _fortran_order, threads);
+
+    return r;
+}
+
+/**
+ * @brief Copies the data in a new buffer in C order, or Fortran order if
+ * @a fortran_order.
+ */
+void array::set_order(bool fortran_order, std::size_t threads)
+{
+    check_writable();
+
+    if(_fortran_order == fortran_order)
+        return;
+
+    // The layout of 1 dimension arrays is the same in both orders
+    if(dimensions() <= 1 || data_size() == 0)
+    {
+        _fortran_order = fortran_order;
+        _strides = element_strides(_shape, fortran_order);
+        return;
+    }
+
+    array tmp(uninitialized, _descr, _shape, fortran_order, _resource);
+    permute_copy(_data, byte_strides(), tmp._data, _descr.stride(), _shape, fortran_order, threads);
+
+    swap(tmp);
+}
+
+namespace
+{
+
+/**
+ * @brief Copies a tile of @a rows by @a cols elements of N bytes, or @a elem
+ * bytes if N is 0. The elements of a row are packed in @a dst and @a src_col
+ * bytes apart in @a src, the rows are @a dst_row and @a src_row bytes apart.
+ */
+template<std::size_t N>
+void copy_tile(const char* src,
+               std::ptrdiff_t src_row,
+               std::ptrdiff_t src_col,
+               char* dst,
+               std::ptrdiff_t dst_row,
+               std::size_t rows,
+               std::size_t cols,
+               std::size_t elem)
+{
+    std::size_t width = N ? N : elem;
+
+    for(std::size_t i = 0; i < rows; i++, src += src_row, dst += dst_row)
+    {
+        const char* s = src;
+        char* d = dst;
+
+        for(std::size_t j = 0; j < cols; j++, s += src_col, d += width)
+            std::memcpy(d, s, N ? N : elem);
+    }
+}
+
+typedef void (*copy_tile_fn)(const char*, std::ptrdiff_t, std::ptrdiff_t,
+                             char*, std::ptrdiff_t,
+                             std::size_t, std::size_t, std::size_t);
+
+copy_tile_fn tile_copier(std::size_t elem)
+{
+    switch(elem)
+    {
+    case 1:  return copy_tile<1>;
+    case 2:  return copy_tile<2>;
+    case 4:  return copy_tile<4>;
+    case 8:  return copy_tile<8>;
+    case 16: return copy_tile<16>;
+    default: return copy_tile<0>;
+    }
+}
+
+}
+
+/**
+ * @brief Copies the elements of @a elem bytes of @a src, @a src_strides bytes
+ * apart along each axis, to @a dst packed in C order, or Fortran order if
+ * @a fortran_order.
+ *
+ * When the fastest axis of @a src is not the one of @a dst, the copy goes by
+ * square tiles over these 2 axes so the lines read from @a src stay in cache
+ * while the tile is written. The tiles are shared between @a threads threads,
+ * 0 meaning one per core.
+ */
+void array::permute_copy(const char* src,
+                         const std::vector<std::ptrdiff_t>& src_strides,
+                         char* dst,
+                         std::size_t elem,
+                         const shape_t& shape,
+                         bool fortran_order,
+                         std::size_t threads)
+{
+    std::size_t n = shape.size();
+
+    if(n == 0)
+        return;
+
+    std::vector<std::ptrdiff_t> dst_strides(n);
+    std::ptrdiff_t s = static_cast<std::ptrdiff_t>(elem);
+
+    for(std::size_t i = 0; i < n; i++)
+    {
+        std::size_t d = fortran_order ? i : n - 1 - i;
+        dst_strides[d] = s;
+        s *= static_cast<std::ptrdiff_t>(shape[d]);
+    }
+
+    // Fastest axis of dst, and of src if it is another one
+    std::size_t fa = fortran_order ? 0 : n - 1;
+    std::size_t fb = fa;
+
+    for(std::size_t d = 0; d < n; d++)
+    {
+        if(d == fa || shape[d] <= 1)
+            continue;
+
+        if(std::abs(src_strides[d]) < std::abs(src_strides[fb]))
+            fb = d;
+    }
+
+    std::size_t edge = 8;
+    while(4 * edge * edge * elem <= transpose_tile_bytes)
+        edge *= 2;
+
+    shape_t outer;
+    std::size_t outer_count = 1;
+
+    for(std::size_t d = 0; d < n; d++)
+    {
+        if(d != fa && d != fb)
+        {
+            outer.push_back(d);
+            outer_count *= shape[d];
+        }
+    }
+
+    std::size_t blocks = fb == fa ? 1 : (shape[fb] + edge - 1) / edge;
+    std::size_t items  = outer_count * blocks;
+
+    if(items == 0)
+        return;
+
+    copy_tile_fn copy = tile_copier(elem);
+    std::atomic<std::size_t> next(0);
+
+    auto worker = [&]()
+    {
+        for(std::size_t item = next++; item < items; item = next++)
+        {
+            std::size_t o = item / blocks;
+            std::size_t b = item % blocks;
+
+            const char* sp = src;
+            char* dp = dst;
+
+            for(std::size_t k = outer.size(); k-- > 0;)
+            {
+                std::size_t d = outer[k];
+                std::size_t c = o % shape[d];
+                o /= shape[d];
+
+                sp += static_cast<std::ptrdiff_t>(c) * src_strides[d];
+                dp += static_cast<std::ptrdiff_t>(c) * dst_strides[d];
+            }
+
+            if(fb == fa)
+            {
+                if(src_strides[fa] == static_cast<std::ptrdiff_t>(elem))
+                    std::memcpy(dp, sp, shape[fa] * elem);
+                else
+                    copy(sp, 0, src_strides[fa], dp, 0, 1, shape[fa], elem);
+
+                continue;
+            }
+
+            std::size_t i0 = b * edge;
+            std::size_t rows = std::min(edge, shape[fb] - i0);
+
+            sp += static_cast<std::ptrdiff_t>(i0) * src_strides[fb];
+            dp += static_cast<std::ptrdiff_t>(i0) * dst_strides[fb];
+
+            for(std::size_t j0 = 0; j0 < shape[fa]; j0 += edge)
+            {
+                copy(sp + static_cast<std::ptrdiff_t>(j0) * src_strides[fa], src_strides[fb], src_strides[fa],
+                     dp + j0 * elem, dst_strides[fb],
+                     rows, std::min(edge, shape[fa] - j0), elem);
+            }
+        }
+    };
+
+    if(threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    threads = std::min(threads, items);
+
+    std::vector<std::thread> pool;
+
+    for(std::size_t t = 1; t < threads; t++)
+        pool.emplace_back(worker);
+
+    worker();
+
+    for(auto& t : pool)
+        t.join();
+}
+
+/**
+ * @brief Returns an iterator pointing to the first element.
+ */
+array::iterator array::begin()
+{
+    iterator it;
+    it._array = this;
+    it._data = _data;
+
+    return it;
+}
+
+/**
+ * @brief Returns a constant iterator pointing to the first element.
+ */
+array::const_iterator array::begin() const
+{
+    return cbegin();
+}
+
+/**
+ * @brief Returns a constant iterator pointing to the first element.
+ */
+array::const_iterator array::cbegin() const
+{
+    iterator it;
+    it._array = const_cast<array*>(this);
+    it._data = _data;
+
+    return it;
+}
+
+/**
+ * @brief Returns an iterator pointing past the last element.
+ */
+array::iterator array::end()
+{
+    iterator it;
+    it._array = this;
+    it._data = _data + data_size();
+
+    return it;
+}
+
+/**
+ * @brief Returns a constant iterator pointing past the last element.
+ */
+array::const_iterator array::end() const
+{
+    return cend();
+}
+
+/**
+ * @brief Returns a constant iterator pointing past the last element.
+ */
+array::const_iterator array::cend() const
+{
+    const_iterator it;
+    it._array = const_cast<array*>(this);
+    it._data = _data + data_size();
+
+    return it;
+}
+
+/**
+ * @brief Returns an iterator pointing at the element at @a index
+ */
+array::iterator array::operator[](std::size_t index)
+{
+    return at_index(index);
+}
+
+/**
+ * @brief Returns a constant iterator pointing at the element at @a index
+ */
+array::const_iterator array::operator[](std::size_t index) const
+{
+    return at_index(index);
+}
+
+/**
+ * @brief Returns an iterator pointing at the element at @a index
+ */
+array::iterator array::at_index(std::size_t index)
+{
+    if(index >= size())
+        throw error("out of range");
+
+    iterator it;
+    it._array = this;
+    it._data = _data + index * _descr.stride();
+
+    return it;
+}
+
+/**
+ * @brief Returns a constant iterator pointing at the element at @a index
+ */
+array::const_iterator array::at_index(std::size_t index) const
+{
+    if(index >= size())
+        throw error("out of range");
+
+    const_iterator it;
+    it._array = const_cast<array*>(this);
+    it._data = _data + index * _descr.stride();
+
+    return it;
+}
+
+/**
+ * @brief Returns an iterator pointing to the coordinates @a indices
+ */
+array::iterator array::at(const std::vector<std::size_t>& indices)
+{
+    return at_index(index(indices));
+}
+
+/**
+ * @brief Returns a constant iterator pointing to the coordinates @a indices
+ */
+array::const_iterator array::at(const std::vector<std::size_t>& indices) const
+{
+    return at_index(index(indices));
+}
+
+/**
+ * @brief Returns a view of all the elements.
+ */
+array_view array::view()
+{
+    return array_view(_data, &_descr, _shape, byte_strides(), _fortran_order);
+}
+
+/**
+ * @brief Returns a constant view of all the elements.
+ */
+const_array_view array::view() const
+{
+    return const_array_view(_data, &_descr, _shape, byte_strides(), _fortran_order);
+}
+
+/**
+ * @brief Returns the view of the elements selected by @a slices, one per axis
+ * starting from the first one, without copying them.
+ *
+ * i.e `auto block = a.slice({{10, 20}, {5, 15}});`
+ *
+ * @throw a np::error if there are more slices than axes or a step is 0.
+ * @see basic_array_view::slice()
+ */
+array_view array::slice(const std::vector<slice_t>& slices)
+{
+    return view().slice(slices);
+}
+
+/**
+ * @brief Returns the constant view of the elements selected by @a slices.
+ * @see slice()
+ */
+const_array_view array::slice(const std::vector<slice_t>& slices) const
+{
+    return view().slice(slices);
+}
+
+/**
+ * @brief Returns the distance between 2 consecutive elements along each axis,
+ * in bytes.
+ */
+std::vector<std::ptrdiff_t> array::byte_strides() const
+{
+    std::vector<std::ptrdiff_t> strides(_strides.size());
+
+    for(std::size_t d = 0; d < _strides.size(); d++)
+        strides[d] = static_cast<std::ptrdiff_t>(_strides[d] * _descr.stride());
+
+    return strides;
+}
+
+/**
+ * @brief Returns the index of the element at coordinates @a indices
+ * @throw a np::error if there is not one coordinate per dimension.
+ */
+std::size_t array::index(const std::vector<std::size_t>& indices) const
+{
+    if(indices.size() != _shape.size())
+        throw error("size does not match");
+
+    return index(indices.data(), indices.size());
+}
+
+/**
+ * @brief Returns the size of the underlying data blob.
+ */
+std::size_t array::data_size() const
+{
+    return size() * _descr.stride();
+}
+
+/**
+ * @brief Returns the alignment of the data of an array of @a size bytes.
+ *
+ * It is at least data_alignment so SIMD loads on data_as() are aligned, and a
+ * huge page for big arrays so they can be backed by huge pages. The latter
+ * only applies to arrays allocated from std::pmr::new_delete_resource(), other
+ * memory resources always get data_alignment.
+ */
+std::size_t array::alignment(std::size_t size)
+{
+    return size >= huge_data_alignment ? huge_data_alignment : data_alignment;
+}
+
+/**
+ * @brief Allocates an aligned uninitialized blob of @a size bytes from the
+ * memory resource of the array.
+ * @return nullptr if @a size is 0.
+ */
+char* array::allocate(std::size_t size)
+{
+    if(size == 0)
+        return nullptr;
+
+    bool heap = _resource == std::pmr::new_delete_resource();
+    std::size_t a = heap ? alignment(size) : data_alignment;
+    char* data = static_cast<char*>(_resource->allocate(size, a));
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if(a == huge_data_alignment)
+        ::madvise(data, size, MADV_HUGEPAGE);
+#endif
+
+    return data;
+}
+
+/**
+ * @brief Frees a blob allocated with allocate() with the same @a size.
+ */
+void array::deallocate(char* data, std::size_t size)
+{
+    if(!data)
+        return;
+
+    bool heap = _resource == std::pmr::new_delete_resource();
+    _resource->deallocate(data, size, heap ? alignment(size) : data_alignment);
+}
+
+/**
+ * @brief Frees the data if owned, or drops the reference to the mapping.
+ *
+ * The shape and descriptor must not have changed the data size since the
+ * allocation.
+ */
+void array::release()
+{
+    if(_mapping)
+        _mapping.reset();
+    else
+        deallocate(_data, data_size());
+
+    _data = nullptr;
+}
+
+
+
+// ====== Utilities ============================================================
+
+
+
+stream_reader::stream_reader(std::istream& stream) :
+    stream(stream)
+{
+    if(!stream)
+        throw error("input stream in fail state");
+}
+
+void stream_reader::read(void *ptr, std::size_t size)
+{
+    stream.read(reinterpret_cast<char*>(ptr), size);
+
+    if(size != stream.gcount())
+        throw error("error while reading input stream: "
+                    "only " + std::to_string(stream.gcount()) + " byte(s) read "
+                    "where " + std::to_string(size) + " byte(s) were expected");
+
+    if(!stream)
+        throw error("error while reading input stream");
+}
+
+void stream_reader::skip(std::size_t size)
+{
+    if(size == 0)
+        return;
+
+    stream.seekg(static_cast<std::streamoff>(size), std::ios_base::cur);
+
+    if(!stream)
+        throw error("error while seeking input stream");
+}
+
+std::size_t stream_reader::available()
+{
+    auto data_start = stream.tellg();
     stream.seekg(0, std::ios_base::end);
     auto data_end = stream.tellg();
     stream.seekg(data_start, std::ios_base::beg);
@@ -547,6 +1528,43 @@ std::size_t stream_reader::available()
     return data_end-data_start;
 }
 
+memory_reader::memory_reader(const char* data, std::size_t size) :
+    data(data),
+    size(size)
+{
+    if(!data)
+        throw error("no data to read");
+}
+
+void memory_reader::read(void* ptr, std::size_t size)
+{
+    if(size > available())
+        throw error("error while reading memory: "
+                    "only " + std::to_string(available()) + " byte(s) available "
+                    "where " + std::to_string(size) + " byte(s) were expected");
+
+    std::memcpy(ptr, data + pos, size);
+    pos += size;
+}
+
+void memory_reader::skip(std::size_t size)
+{
+    if(size > available())
+        throw error("skipping past the end of memory");
+
+    pos += size;
+}
+
+std::size_t memory_reader::available()
+{
+    return size - pos;
+}
+
+std::size_t memory_reader::position() const
+{
+    return pos;
+}
+
 stream_writer::stream_writer(std::ostream& stream) :
     stream(stream)
 {
@@ -597,67 +1615,28 @@ void file_io::write(const void* ptr, std::size_t size)
                     "where " + std::to_string(size) + "byte(s) were expected");
 }
 
-std::size_t file_io::available()
-{
-    auto data_start = std::ftell(file);
-    std::fseek(file, 0, SEEK_END);
-    auto data_end = std::ftell(file);
-    std::fseek(file, data_start, SEEK_SET);
-
-    return data_end-data_start;
-}
-
-
-
-
-// ====== NPZ ==================================================================
-
-
-
-/**
- * @brief Loads the give npz @a file
- */
-npz npz_load(const fs::path& file)
+void file_io::skip(std::size_t size)
 {
-    std::unordered_map<std::string, array> arrays;
-
-    miniz_cpp::zip_file f;
+    // fseek takes a long, which is only 32 bits on some platforms
+    while(size > 0)
+    {
+        long step = static_cast<long>(std::min<std::size_t>(size, LONG_MAX));
 
-    f.load(file.string());
+        if(std::fseek(file, step, SEEK_CUR) != 0)
+            throw error(std::strerror(errno));
 
-    for(auto npy_n : f.namelist())
-    {
-        std::string content = f.read(npy_n);
-        std::istringstream iss (content);
-        npy_n.erase(npy_n.size()-4);
-        arrays.emplace(npy_n, array::load(iss));
+        size -= static_cast<std::size_t>(step);
     }
-
-    return arrays;
 }
 
-/**
- * @brief Saves the given set of @a arrays into a npz @a file
- */
-void npz_save(const npz &arrays, const fs::path& file)
+std::size_t file_io::available()
 {
-    miniz_cpp::zip_file f;
-
-    for(auto& e : arrays)
-    {
-        std::stringstream st;
-        try
-        {
-            e.second.save(st);
-            f.writestr(e.first+".npy", st.str());
-        }
-        catch(std::exception& ex)
-        {
-            throw error(e.first + " - " + ex.what());
-        }
-    }
+    auto data_start = std::ftell(file);
+    std::fseek(file, 0, SEEK_END);
+    auto data_end = std::ftell(file);
+    std::fseek(file, data_start, SEEK_SET);
 
-    f.save(file.string());
+    return data_end-data_start;
 }
 
 }
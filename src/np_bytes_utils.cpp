@@ -1,7 +1,17 @@
 #include <numpycpp/np_bytes_utils.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define NP_BYTE_SWAP_X86
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#define NP_BYTE_SWAP_NEON
+#include <arm_neon.h>
+#endif
 
 namespace np
 {
@@ -75,4 +85,206 @@ void byte_swap(void* value, std::size_t size)
     }
 }
 
+
+
+// ====== Bulk byte swap =======================================================
+
+
+
+namespace
+{
+
+/**
+ * @brief Swaps @a count values of type T, @a stride bytes apart.
+ */
+template<class T, T (*swap)(T)>
+void swap_values(unsigned char* ptr, std::size_t count, std::size_t stride)
+{
+    for(std::size_t i = 0; i < count; i++, ptr += stride)
+    {
+        T v;
+        std::memcpy(&v, ptr, sizeof (T));
+        v = swap(v);
+        std::memcpy(ptr, &v, sizeof (T));
+    }
+}
+
+#if defined(NP_BYTE_SWAP_X86)
+
+/**
+ * @brief Returns the pshufb mask reversing each @a width bytes of a 16 bytes
+ * lane.
+ */
+__m128i shuffle_mask(std::size_t width)
+{
+    alignas(16) char mask[16];
+
+    for(std::size_t i = 0; i < 16; i++)
+        mask[i] = static_cast<char>((i / width) * width + width - 1 - i % width);
+
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+}
+
+/**
+ * @brief Swaps the values of @a width bytes in the first @a size bytes at
+ * @a ptr, 32 bytes at a time.
+ * @return the number of bytes swapped, a multiple of 32.
+ */
+__attribute__((target("avx2")))
+std::size_t swap_avx2(unsigned char* ptr, std::size_t size, std::size_t width)
+{
+    const __m256i mask = _mm256_broadcastsi128_si256(shuffle_mask(width));
+    std::size_t i = 0;
+
+    for(; i + 32 <= size; i += 32)
+    {
+        __m256i* p = reinterpret_cast<__m256i*>(ptr + i);
+        _mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), mask));
+    }
+
+    return i;
+}
+
+/**
+ * @brief Same as swap_avx2(), 16 bytes at a time.
+ */
+__attribute__((target("ssse3")))
+std::size_t swap_ssse3(unsigned char* ptr, std::size_t size, std::size_t width)
+{
+    const __m128i mask = shuffle_mask(width);
+    std::size_t i = 0;
+
+    for(; i + 16 <= size; i += 16)
+    {
+        __m128i* p = reinterpret_cast<__m128i*>(ptr + i);
+        _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), mask));
+    }
+
+    return i;
+}
+
+std::size_t swap_none(unsigned char*, std::size_t, std::size_t)
+{
+    return 0;
+}
+
+/**
+ * @brief Swaps as many bytes as the CPU allows with SIMD instructions, picked
+ * once at runtime.
+ * @return the number of bytes swapped.
+ */
+std::size_t swap_simd(unsigned char* ptr, std::size_t size, std::size_t width)
+{
+    typedef std::size_t (*kernel_t)(unsigned char*, std::size_t, std::size_t);
+
+    static const kernel_t kernel = []() -> kernel_t
+    {
+        __builtin_cpu_init();
+
+        if(__builtin_cpu_supports("avx2"))
+            return swap_avx2;
+        else if(__builtin_cpu_supports("ssse3"))
+            return swap_ssse3;
+        else
+            return swap_none;
+    }();
+
+    return kernel(ptr, size, width);
+}
+
+#elif defined(NP_BYTE_SWAP_NEON)
+
+/**
+ * @brief Swaps as many bytes as possible with NEON instructions, 16 at a time.
+ * @return the number of bytes swapped.
+ */
+std::size_t swap_simd(unsigned char* ptr, std::size_t size, std::size_t width)
+{
+    std::size_t i = 0;
+
+    for(; i + 16 <= size; i += 16)
+    {
+        uint8x16_t v = vld1q_u8(ptr + i);
+
+        switch(width)
+        {
+        case 2: v = vrev16q_u8(v); break;
+        case 4: v = vrev32q_u8(v); break;
+        case 8: v = vrev64q_u8(v); break;
+        }
+
+        vst1q_u8(ptr + i, v);
+    }
+
+    return i;
+}
+
+#else
+
+std::size_t swap_simd(unsigned char*, std::size_t, std::size_t)
+{
+    return 0;
+}
+
+#endif
+
+}
+
+/**
+ * @brief Swaps the bytes of @a count values of @a width bytes, @a stride
+ * bytes apart, starting at @a data.
+ *
+ * This is what structured arrays use, one field at a time.
+ */
+void byte_swap(void* data, std::size_t width, std::size_t count, std::size_t stride)
+{
+    auto ptr = static_cast<unsigned char*>(data);
+
+    switch(width)
+    {
+    case 0:
+    case 1:
+        break;
+
+    case 2:
+        swap_values<std::uint16_t, byte_swap16>(ptr, count, stride);
+        break;
+
+    case 4:
+        swap_values<std::uint32_t, byte_swap32>(ptr, count, stride);
+        break;
+
+    case 8:
+        swap_values<std::uint64_t, byte_swap64>(ptr, count, stride);
+        break;
+
+    default:
+        for(std::size_t i = 0; i < count; i++, ptr += stride)
+            std::reverse(ptr, ptr + width);
+        break;
+    }
+}
+
+/**
+ * @brief Swaps the bytes of @a count contiguous values of @a width bytes
+ * starting at @a data.
+ *
+ * Values of 2, 4 and 8 bytes are swapped with SIMD shuffles when the CPU
+ * has them (AVX2 or SSSE3 on x86, NEON on ARM).
+ */
+void byte_swap(void* data, std::size_t width, std::size_t count)
+{
+    if(width < 2 || count == 0)
+        return;
+
+    auto ptr = static_cast<unsigned char*>(data);
+    std::size_t size = width * count;
+    std::size_t done = 0;
+
+    if(width == 2 || width == 4 || width == 8)
+        done = swap_simd(ptr, size, width);
+
+    byte_swap(ptr + done, width, (size - done) / width, width);
+}
+
 }
@@ -1,12 +1,69 @@
 #include <numpycpp/np_descr_t.h>
 #include <numpycpp/np_error.h>
 
-#include <regex>
 #include <string>
 #include <string_view>
 
 namespace np
 {
+
+namespace
+{
+/**
+ * @brief Returns wether @a name is a generated field name like f0, f1...
+ */
+bool is_default_name(const std::string& name)
+{
+    if(name.size() < 2 || name[0] != 'f')
+        return false;
+
+    for(std::size_t i = 1; i < name.size(); i++)
+    {
+        if(name[i] < '0' || name[i] > '9')
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Returns wether @a l is a ('', '|V<n>') padding tuple, as numpy puts in
+ * the descriptors of aligned dtypes, and stores n in @a size.
+ */
+bool is_padding(const details::literal& l, std::size_t& size)
+{
+    if(!l.is(details::literal::Tuple) || l.size() != 2 ||
+       !l[0].is(details::literal::String) || !l[1].is(details::literal::String) ||
+       !l[0].string().empty())
+        return false;
+
+    std::string_view t = l[1].string();
+
+    if(t.size() < 3 || t[0] != '|' || t[1] != 'V')
+        return false;
+
+    size = 0;
+
+    for(std::size_t i = 2; i < t.size(); i++)
+    {
+        if(t[i] < '0' || t[i] > '9')
+            return false;
+
+        size = size * 10 + (t[i] - '0');
+    }
+
+    return true;
+}
+
+/**
+ * @brief Returns the ('', '|V<n>') padding tuple of @a size bytes.
+ */
+std::string padding(std::size_t size)
+{
+    return "('','|V" + std::to_string(size) + "'),";
+}
+}
+
 /**
  * @brief Swaps the content of 2 descriptors
  */
@@ -17,85 +74,89 @@ void descr_t::swap(descr_t& o)
     std::swap(_stride, o._stride);
 }
 
+/**
+ * @brief Returns wether the 2 descriptors have the same fields, in the same
+ * order, with the same types and the same stride.
+ */
+bool descr_t::operator==(const descr_t& o) const
+{
+    return _stride == o._stride && _fields == o._fields;
+}
+
+/**
+ * @brief Same as !(*this == o)
+ */
+bool descr_t::operator!=(const descr_t& o) const
+{
+    return !(*this == o);
+}
+
 /**
  * @brief Parses the descriptor string @a str as given by the numpy file header.
  * @return A descr_t representation of @a str.
  */
-descr_t descr_t::from_string(const std::string& str)
+descr_t descr_t::from_string(std::string_view str)
 {
-    descr_t r;
+    details::literal l;
 
-    if((str.front() == '\'' && str.back() == '\'') || (str.front() == '"' && str.back() == '"'))
+    try
     {
-        type_t t = type_t::from_string(str);
-        r._fields.emplace_back("f0", t);
-        r._lookup.emplace("f0", 0);
-        r._stride = t._size;
+        l = details::literal::parse(str);
     }
-    else if(str.front() == '(' && str.back() == ')')
+    catch(std::exception& e)
     {
-        auto p = parse_tuple(str);
-
-        if(p.first.empty())
-            p.first = "f0";
-
-        r._stride = p.second._size;
-        r._lookup.emplace(p.first, 0);
-        r._fields.emplace_back(std::move(p));
+        throw error("can't parse dtype " + std::string(str) + ": " + e.what());
     }
-    else if(str.front() == '[' && str.back() == ']')
-    {
-        std::string t = str.substr(1, str.size()-2);
-
-        std::string tmp;
-        int f = 0;
 
-        auto b = t.begin();
-        auto e = t.end();
-
-        for(auto it = b; it != e;)
-        {
-            auto& c = *it;
+    return from_literal(l);
+}
 
-            if(c == '(')
-            {
-                tmp = extract(it, e, '(', ')');
+/**
+ * @brief Builds a descriptor from the already parsed literal @a l.
+ *
+ * It is either a single type string, a single (name, type) tuple, or a list of
+ * type strings and (name, type) tuples.
+ */
+descr_t descr_t::from_literal(const details::literal& l)
+{
+    descr_t r;
 
-                auto p = parse_tuple(tmp);
+    switch(l.kind())
+    {
+    case details::literal::String:
+        r.push_back(type_t::from_string(l.string()));
+        break;
 
-                if(p.first.empty())
-                    p.first = "f" + std::to_string(f);
+    case details::literal::Tuple:
+    {
+        auto p = parse_tuple(l);
+        r.push_back(p.second, std::move(p.first));
+        break;
+    }
 
-                p.second._offset = r._stride;
-                r._stride += p.second._size;
-                r._lookup.emplace(p.first, f);
-                r._fields.emplace_back(std::move(p));
+    case details::literal::List:
+        for(std::size_t i = 0; i < l.size(); i++)
+        {
+            auto& e = l[i];
+            std::size_t pad = 0;
 
-                ++f;
-            }
-            else if(c == '\'')
+            if(is_padding(e, pad))
+                r._stride += pad;
+            else if(e.is(details::literal::Tuple))
             {
-                tmp = extract(it, e, '\'', '\'');
-
-                std::string name = "f" + std::to_string(f);
-
-                type_t t = type_t::from_string(tmp);
-
-                t._offset = r._stride;
-                r._stride += t._size;
-                r._lookup.emplace(name, f);
-                r._fields.emplace_back(name, t);
-
-                ++f;
+                auto p = parse_tuple(e);
+                r.push_back(p.second, std::move(p.first));
             }
-            else if(c != ',' && c != ' ')
-                throw error("can't parse dtype " + str);
+            else if(e.is(details::literal::String))
+                r.push_back(type_t::from_string(e.string()));
             else
-                ++it;
+                throw error("can't parse dtype " + std::string(l.text()));
         }
+        break;
+
+    default:
+        throw error("can't parse dtype " + std::string(l.text()));
     }
-    else
-        throw error("can't parse dtype " + str);
 
     return r;
 }
@@ -109,12 +170,13 @@ std::string descr_t::to_string() const
     if(_fields.empty())
         return std::string();
 
-    std::regex unnamed_test("f\\d+");
+    auto& last = _fields.back().second;
+    bool padded = _fields.front().second._offset != 0 || last._offset + last._size != _stride;
 
-    if(_fields.size() == 1)
+    if(_fields.size() == 1 && !padded)
     {
         auto& p = *_fields.begin();
-        if(std::regex_match(p.first, unnamed_test))
+        if(is_default_name(p.first))
             return _fields.begin()->second.to_string();
         else
             return "('" + p.first + "'," + p.second.to_string() + ")";
@@ -122,15 +184,24 @@ std::string descr_t::to_string() const
 
 
     std::string r = "[";
+    std::size_t end = 0;
 
     for(auto& f : _fields)
     {
-        if(std::regex_match(f.first, unnamed_test))
+        if(f.second._offset > end)
+            r += padding(f.second._offset - end);
+
+        if(is_default_name(f.first))
             r += "(''," + f.second.to_string() + "),";
         else
             r += "('" + f.first + "'," + f.second.to_string() + "),";
+
+        end = f.second._offset + f.second._size;
     }
 
+    if(_stride > end)
+        r += padding(_stride - end);
+
     r += "]";
 
     return r;
@@ -217,87 +288,23 @@ std::size_t descr_t::size() const
     return _fields.size();
 }
 
-/**
- * @brief Extracts a string in between 2 characters (like [ ] or ( ) or ' '
- * @param it an iterator pointing to the openning character
- * @param end the end of the string
- * @param b the openning character
- * @param e the closing character
- * @return the extracted string including the opening/closing characters
- */
-std::string descr_t::extract(std::string::iterator& it,
-                             const std::string::iterator& end,
-                             char b,
-                             char e)
-{
-    if(*it != b)
-        throw error("bad extract call");
-
-    std::string::iterator start = it;
-
-    ++it;
-
-    int d = 0;
-
-    while((*it != e || d != 0) && it != end)
-    {
-        if(*it == b)
-            ++d;
-        else if(*it == e)
-            --d;
-
-        ++it;
-    }
-
-    ++it;
-
-    return std::string(start, it);
-}
-
 /**
  * @brief Parses a simple tuple ('name', 'type')
  *
  * any other tuple will raise an error
  */
-std::pair<std::string, type_t> descr_t::parse_tuple(const std::string& str)
+std::pair<std::string, type_t> descr_t::parse_tuple(const details::literal& l)
 {
-    if(str.front() != '(' || str.back() != ')')
+    if(!l.is(details::literal::Tuple) || l.size() < 2)
         throw error("wrong tuple");
 
-    std::string_view view(str);
-    view.remove_prefix(1);
-    view.remove_suffix(1);
-
-    std::size_t idx = view.find(',');
-
-    std::string_view name_view = view.substr(0, idx);
-
-    if((name_view.front() == '\'' && name_view.back() == '\'') || (name_view.front() == '"' && name_view.back() == '"'))
-    {
-        name_view.remove_prefix(1);
-        name_view.remove_suffix(1);
-    }
-
-    idx++;
-
-    while(view[idx] == ' ')
-        idx++;
-
-    std::size_t idx2 = view.find(',', idx);
-
-    if(idx2 != std::string::npos)
-    {
-        if(idx2 != view.size()-1)
-            throw error("does not handle sub arrays or fixed length strings");
-    }
-    else
-        idx2 = view.size();
-
-    std::string_view type_view = view.substr(idx, idx2-idx);
+    if(l.size() > 2)
+        throw error("does not handle sub arrays or fixed length strings");
 
-    type_t type = type_t::from_string({type_view.begin(), type_view.end()});
+    std::string_view name = l[0].string();
+    type_t type = type_t::from_string(l[1].string());
 
-    return {{name_view.begin(), name_view.end()}, type};
+    return {std::string(name), type};
 }
 
 namespace details
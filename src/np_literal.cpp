@@ -0,0 +1,407 @@
+#include <numpycpp/np_literal.h>
+#include <numpycpp/np_error.h>
+
+#include <cstdint>
+#include <string>
+
+namespace np
+{
+
+namespace details
+{
+
+/**
+ * @brief The literal::parser class is a recursive descent parser for the
+ * subset of python literals written by numpy.
+ */
+class literal::parser
+{
+public:
+    parser(std::string_view text) : _text(text) {}
+
+    literal parse()
+    {
+        literal r = value();
+
+        skip_spaces();
+
+        if(_pos != _text.size())
+            unexpected();
+
+        return r;
+    }
+
+private:
+    literal value()
+    {
+        skip_spaces();
+
+        if(_pos >= _text.size())
+            throw error("unexpected end of literal");
+
+        std::size_t start = _pos;
+        literal r;
+
+        switch(_text[_pos])
+        {
+        case '{':
+            r = dict();
+            break;
+
+        case '(':
+            r = sequence(Tuple, ')');
+            break;
+
+        case '[':
+            r = sequence(List, ']');
+            break;
+
+        case '\'':
+        case '"':
+            r._kind = String;
+            r._string = string();
+            break;
+
+        default:
+            r = scalar();
+            break;
+        }
+
+        r._text = _text.substr(start, _pos - start);
+        return r;
+    }
+
+    literal dict()
+    {
+        enter();
+
+        literal r;
+        r._kind = Dict;
+
+        ++_pos;
+
+        while(true)
+        {
+            skip_spaces();
+
+            if(peek() == '}')
+                break;
+
+            if(peek() != '\'' && peek() != '"')
+                unexpected();
+
+            r._keys.push_back(string());
+
+            skip_spaces();
+            expect(':');
+
+            r._items.push_back(value());
+
+            skip_spaces();
+
+            if(peek() == ',')
+                ++_pos;
+            else if(peek() != '}')
+                unexpected();
+        }
+
+        ++_pos;
+        --_depth;
+
+        return r;
+    }
+
+    literal sequence(Kind kind, char close)
+    {
+        enter();
+
+        literal r;
+        r._kind = kind;
+
+        ++_pos;
+
+        while(true)
+        {
+            skip_spaces();
+
+            if(peek() == close)
+                break;
+
+            r._items.push_back(value());
+
+            skip_spaces();
+
+            if(peek() == ',')
+                ++_pos;
+            else if(peek() != close)
+                unexpected();
+        }
+
+        ++_pos;
+        --_depth;
+
+        return r;
+    }
+
+    std::string_view string()
+    {
+        char quote = _text[_pos++];
+        std::size_t start = _pos;
+
+        while(_pos < _text.size() && _text[_pos] != quote)
+        {
+            if(_text[_pos] == '\\')
+                ++_pos;
+
+            ++_pos;
+        }
+
+        if(_pos >= _text.size())
+            throw error("unterminated string");
+
+        return _text.substr(start, _pos++ - start);
+    }
+
+    literal scalar()
+    {
+        literal r;
+
+        if(consume("True"))
+        {
+            r._kind = Bool;
+            r._boolean = true;
+        }
+        else if(consume("False"))
+        {
+            r._kind = Bool;
+            r._boolean = false;
+        }
+        else if(consume("None"))
+            r._kind = None;
+        else
+        {
+            bool negative = false;
+
+            if(peek() == '-' || peek() == '+')
+                negative = _text[_pos++] == '-';
+
+            if(!is_digit(peek()))
+                unexpected();
+
+            std::int64_t v = 0;
+
+            while(is_digit(peek()))
+            {
+                int d = _text[_pos++] - '0';
+
+                if(v > (INT64_MAX - d) / 10)
+                    throw error("integer too large");
+
+                v = v * 10 + d;
+            }
+
+            // python 2 long suffix, numpy used to write shapes like (3L,)
+            if(peek() == 'L')
+                ++_pos;
+
+            r._kind = Integer;
+            r._integer = negative ? -v : v;
+        }
+
+        return r;
+    }
+
+    bool consume(std::string_view word)
+    {
+        if(_text.substr(_pos, word.size()) != word)
+            return false;
+
+        _pos += word.size();
+        return true;
+    }
+
+    void expect(char c)
+    {
+        if(peek() != c)
+            unexpected();
+
+        ++_pos;
+    }
+
+    /**
+     * @brief Counts one more level of containers, the header comes from the
+     * file so its nesting is bounded instead of the stack.
+     */
+    void enter()
+    {
+        if(++_depth > max_depth)
+            throw error("literal nested too deeply");
+    }
+
+    char peek() const
+    {
+        return _pos < _text.size() ? _text[_pos] : '\0';
+    }
+
+    void skip_spaces()
+    {
+        while(_pos < _text.size() &&
+              (_text[_pos] == ' '  || _text[_pos] == '\n' ||
+               _text[_pos] == '\t' || _text[_pos] == '\r'))
+            ++_pos;
+    }
+
+    [[noreturn]] void unexpected() const
+    {
+        if(_pos >= _text.size())
+            throw error("unexpected end of literal");
+
+        throw error("unexpected character '" + std::string(1, _text[_pos]) + "' "
+                    "at position " + std::to_string(_pos));
+    }
+
+    static bool is_digit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+private:
+    static constexpr std::size_t max_depth = 32;
+
+    std::string_view _text;
+    std::size_t      _pos   = 0;
+    std::size_t      _depth = 0;
+};
+
+/**
+ * @brief Parses the python literal @a text.
+ * @throw a np::error if @a text is not a valid literal.
+ */
+literal literal::parse(std::string_view text)
+{
+    return parser(text).parse();
+}
+
+/**
+ * @brief Returns the kind of literal held.
+ */
+literal::Kind literal::kind() const
+{
+    return _kind;
+}
+
+/**
+ * @brief Returns wether the literal is of kind @a k.
+ */
+bool literal::is(Kind k) const
+{
+    return _kind == k;
+}
+
+/**
+ * @brief Returns the source text of the literal.
+ */
+std::string_view literal::text() const
+{
+    return _text;
+}
+
+/**
+ * @brief Returns the value of a True/False literal.
+ * @throw a np::error if the literal is not a boolean.
+ */
+bool literal::boolean() const
+{
+    if(_kind != Bool)
+        throw error("not a boolean: " + std::string(_text));
+
+    return _boolean;
+}
+
+/**
+ * @brief Returns the value of an integer literal.
+ * @throw a np::error if the literal is not an integer.
+ */
+std::int64_t literal::integer() const
+{
+    if(_kind != Integer)
+        throw error("not an integer: " + std::string(_text));
+
+    return _integer;
+}
+
+/**
+ * @brief Returns the content of a string literal, without the quotes.
+ * @throw a np::error if the literal is not a string.
+ */
+std::string_view literal::string() const
+{
+    if(_kind != String)
+        throw error("not a string: " + std::string(_text));
+
+    return _string;
+}
+
+/**
+ * @brief Returns the number of items of a tuple, a list or a dict.
+ */
+std::size_t literal::size() const
+{
+    return _items.size();
+}
+
+/**
+ * @brief Returns the item at @a index of a tuple, a list or a dict.
+ * @throw a np::error if out of range.
+ */
+const literal& literal::operator[](std::size_t index) const
+{
+    if(index >= _items.size())
+        throw error("out of range");
+
+    return _items[index];
+}
+
+/**
+ * @brief Returns the value of the dict at @a key.
+ * @throw a np::error if the key does not exist.
+ */
+const literal& literal::operator[](std::string_view key) const
+{
+    auto r = find(key);
+
+    if(!r)
+        throw error("key '" + std::string(key) + "' does not exist");
+
+    return *r;
+}
+
+/**
+ * @brief Returns a pointer to the value of the dict at @a key or nullptr.
+ */
+const literal* literal::find(std::string_view key) const
+{
+    for(std::size_t i = 0; i < _keys.size(); i++)
+    {
+        if(_keys[i] == key)
+            return &_items[i];
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Returns the key at @a index of a dict.
+ * @throw a np::error if out of range.
+ */
+std::string_view literal::key(std::size_t index) const
+{
+    if(index >= _keys.size())
+        throw error("out of range");
+
+    return _keys[index];
+}
+
+}
+
+}
@@ -0,0 +1,180 @@
+#include <numpycpp/np_mapped_file.h>
+#include <numpycpp/np_error.h>
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace np
+{
+
+/**
+ * @brief Maps the whole @a file in memory according to @a mode.
+ * @throw a np::error on failure.
+ */
+mapped_file::mapped_file(const fs::path& file, MapMode mode) :
+    _mode(mode)
+{
+#ifdef _WIN32
+    DWORD access  = mode == ReadWrite ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+    DWORD protect = PAGE_READONLY;
+    DWORD view    = FILE_MAP_READ;
+
+    if(mode == CopyOnWrite)
+    {
+        protect = PAGE_WRITECOPY;
+        view    = FILE_MAP_COPY;
+    }
+    else if(mode == ReadWrite)
+    {
+        protect = PAGE_READWRITE;
+        view    = FILE_MAP_WRITE;
+    }
+
+    HANDLE f = CreateFileW(file.wstring().c_str(), access, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if(f == INVALID_HANDLE_VALUE)
+        throw error("unable to open file");
+
+    _file = f;
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(f, &size))
+    {
+        CloseHandle(f);
+        throw error("unable to get file size");
+    }
+
+    _size = static_cast<std::size_t>(size.QuadPart);
+
+    if(_size == 0)
+    {
+        CloseHandle(f);
+        throw error("unable to map an empty file");
+    }
+
+    HANDLE m = CreateFileMappingW(f, nullptr, protect, 0, 0, nullptr);
+
+    if(!m)
+    {
+        CloseHandle(f);
+        throw error("unable to map file");
+    }
+
+    _mapping = m;
+    _data = static_cast<char*>(MapViewOfFile(m, view, 0, 0, 0));
+
+    if(!_data)
+    {
+        CloseHandle(m);
+        CloseHandle(f);
+        throw error("unable to map file");
+    }
+#else
+    int fd = ::open(file.c_str(), mode == ReadWrite ? O_RDWR : O_RDONLY);
+
+    if(fd < 0)
+        throw error("unable to open file");
+
+    struct stat st;
+    if(::fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        throw error(std::strerror(errno));
+    }
+
+    _size = static_cast<std::size_t>(st.st_size);
+
+    if(_size == 0)
+    {
+        ::close(fd);
+        throw error("unable to map an empty file");
+    }
+
+    int prot  = mode == ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+    int flags = mode == ReadWrite ? MAP_SHARED : MAP_PRIVATE;
+
+    void* ptr = ::mmap(nullptr, _size, prot, flags, fd, 0);
+
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+
+    if(ptr == MAP_FAILED)
+        throw error(std::strerror(errno));
+
+    _data = static_cast<char*>(ptr);
+#endif
+}
+
+/**
+ * @brief Unmaps the file. Changes made in ReadWrite mode are written back.
+ */
+mapped_file::~mapped_file()
+{
+#ifdef _WIN32
+    UnmapViewOfFile(_data);
+    CloseHandle(_mapping);
+    CloseHandle(_file);
+#else
+    ::munmap(_data, _size);
+#endif
+}
+
+/**
+ * @brief Returns a pointer to the first byte of the mapping.
+ */
+char* mapped_file::data() const
+{
+    return _data;
+}
+
+/**
+ * @brief Returns the size of the mapping, which is the size of the file.
+ */
+std::size_t mapped_file::size() const
+{
+    return _size;
+}
+
+/**
+ * @brief Returns the mode the file has been mapped with.
+ */
+MapMode mapped_file::mode() const
+{
+    return _mode;
+}
+
+/**
+ * @brief Flushes the changes to the underlying file.
+ *
+ * Does nothing unless the file is mapped in ReadWrite mode.
+ * @throw a np::error on failure.
+ */
+void mapped_file::sync()
+{
+    if(_mode != ReadWrite)
+        return;
+
+#ifdef _WIN32
+    if(!FlushViewOfFile(_data, 0) || !FlushFileBuffers(_file))
+        throw error("unable to flush mapped file");
+#else
+    if(::msync(_data, _size, MS_SYNC) != 0)
+        throw error(std::strerror(errno));
+#endif
+}
+
+}
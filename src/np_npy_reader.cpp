@@ -0,0 +1,228 @@
+#include <numpycpp/np_npy_reader.h>
+#include <numpycpp/np_error.h>
+
+#include <algorithm>
+
+namespace fs = std::filesystem;
+
+namespace np
+{
+
+/**
+ * @brief Opens the npy @a file and reads its header.
+ *
+ * @param file The file to read.
+ * @param chunk_rows The number of rows per chunk, the last one may be shorter.
+ * @param read_ahead Wether to read the next chunk on a background thread.
+ * @throw a np::error on failure.
+ */
+npy_reader::npy_reader(const fs::path& file, std::size_t chunk_rows, bool read_ahead) :
+    _chunk_rows(chunk_rows)
+{
+    if(_chunk_rows == 0)
+        throw error("chunks must have at least 1 row");
+
+    _file = std::fopen(file.string().c_str(), "rb");
+
+    if(!_file)
+        throw error("unable to open file");
+
+    try
+    {
+        _info = array::inspect(_file);
+
+        if(_info.shape.empty())
+            throw error("can't read rows of a 0 dimension array");
+
+        _rows = _info.fortran_order ? _info.shape.back() : _info.shape.front();
+
+        std::size_t expected = _info.descr.stride();
+        for(auto& d : _info.shape)
+            expected *= d;
+
+        std::size_t available = file_io(_file).available();
+
+        if(available != expected)
+            throw error("error while reading file. "
+                        "only " + std::to_string(available) + "bytes available "
+                        "where " + std::to_string(expected) + "bytes were expected");
+    }
+    catch(...)
+    {
+        std::fclose(_file);
+        throw;
+    }
+
+    if(read_ahead)
+        _thread = std::thread(&npy_reader::read_ahead, this);
+}
+
+/**
+ * @brief Stops the read ahead thread and closes the file.
+ */
+npy_reader::~npy_reader()
+{
+    if(_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+
+        _cv.notify_all();
+        _thread.join();
+    }
+
+    std::fclose(_file);
+}
+
+/**
+ * @brief Returns the header of the file.
+ */
+const header_info& npy_reader::info() const
+{
+    return _info;
+}
+
+/**
+ * @brief Returns the total number of rows in the file.
+ */
+std::size_t npy_reader::rows() const
+{
+    return _rows;
+}
+
+/**
+ * @brief Returns the number of rows per chunk.
+ */
+std::size_t npy_reader::chunk_rows() const
+{
+    return _chunk_rows;
+}
+
+/**
+ * @brief Makes @a chunk hold the next rows of the file.
+ *
+ * The previous content of @a chunk is recycled to read the following chunk
+ * when it has the right size.
+ *
+ * @return false once all the rows have been read.
+ * @throw a np::error on failure.
+ */
+bool npy_reader::next(array& chunk)
+{
+    if(!_thread.joinable())
+        return read_chunk(chunk);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [this](){ return _ahead_ready || _ahead_end; });
+
+    if(_ahead_ready)
+    {
+        chunk.swap(_ahead);
+        _ahead_ready = false;
+
+        lock.unlock();
+        _cv.notify_all();
+
+        return true;
+    }
+
+    if(_error)
+        std::rethrow_exception(_error);
+
+    return false;
+}
+
+/**
+ * @brief Reads the next rows of the file in @a chunk, reusing its buffer if
+ * it has the right size.
+ * @return false if there is nothing left to read.
+ */
+bool npy_reader::read_chunk(array& chunk)
+{
+    if(_read_rows >= _rows)
+        return false;
+
+    std::size_t count = std::min(_chunk_rows, _rows - _read_rows);
+
+    shape_t shape = _info.shape;
+
+    if(_info.fortran_order)
+        shape.back() = count;
+    else
+        shape.front() = count;
+
+    if(chunk.mapped() ||
+       chunk.shape() != shape ||
+       chunk.descr() != _info.descr ||
+       chunk.fortran_order() != _info.fortran_order)
+    {
+        array tmp(uninitialized, _info.descr, shape, _info.fortran_order);
+        chunk.swap(tmp);
+    }
+
+    if(chunk.data_size() > 0)
+        file_io(_file).read(chunk._data, chunk.data_size());
+
+    _read_rows += count;
+
+    return true;
+}
+
+/**
+ * @brief The read ahead thread loop, reads the next chunk as soon as the
+ * previous one has been taken by next().
+ */
+void npy_reader::read_ahead()
+{
+    while(true)
+    {
+        array buffer;
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [this](){ return _stop || !_ahead_ready; });
+
+            if(_stop)
+                return;
+
+            // The chunk given back by next(), if any
+            buffer.swap(_ahead);
+        }
+
+        bool more = false;
+        std::exception_ptr e;
+
+        try
+        {
+            more = read_chunk(buffer);
+        }
+        catch(...)
+        {
+            e = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if(more)
+            {
+                _ahead.swap(buffer);
+                _ahead_ready = true;
+            }
+            else
+            {
+                _error = e;
+                _ahead_end = true;
+            }
+        }
+
+        _cv.notify_all();
+
+        if(!more)
+            return;
+    }
+}
+
+}
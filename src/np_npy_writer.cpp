@@ -0,0 +1,231 @@
+#include <numpycpp/np_npy_writer.h>
+#include <numpycpp/np_error.h>
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+namespace fs = std::filesystem;
+
+namespace np
+{
+
+/**
+ * @brief Creates the npy @a file and writes a placeholder header for an array
+ * of rows of @a row_shape elements described by @a descr.
+ *
+ * @param file The file to write.
+ * @param descr The structure descriptor of the elements.
+ * @param row_shape The shape of a row, without the row axis.
+ * @param fortran_order Wether the array is in Fortran order.
+ * @throw a np::error on failure.
+ */
+npy_writer::npy_writer(const fs::path& file,
+                       descr_t descr,
+                       shape_t row_shape,
+                       bool fortran_order) :
+    _descr(std::move(descr)),
+    _row_shape(std::move(row_shape)),
+    _fortran_order(fortran_order)
+{
+    if(_descr.empty())
+        throw error("empty descriptor");
+
+    _row_size = _descr.stride();
+    for(auto& d : _row_shape)
+        _row_size *= d;
+
+    _file = std::fopen(file.string().c_str(), "wb");
+
+    if(!_file)
+        throw error("unable to open file");
+
+    try
+    {
+        write_header(_file, 0);
+    }
+    catch(...)
+    {
+        std::fclose(_file);
+        _file = nullptr;
+        throw;
+    }
+}
+
+/**
+ * @brief Closes the file if still open, errors are ignored. Call close()
+ * explicitely to get them.
+ */
+npy_writer::~npy_writer()
+{
+    try
+    {
+        close();
+    }
+    catch(...)
+    {
+    }
+}
+
+/**
+ * @brief Appends @a rows rows read from @a data, which must hold
+ * `rows * row_size()` bytes.
+ * @throw a np::error on failure.
+ */
+void npy_writer::append(const void* data, std::size_t rows)
+{
+    if(!_file)
+        throw error("writer is closed");
+
+    if(rows == 0)
+        return;
+
+    file_io io(_file);
+    io.write(data, rows * _row_size);
+
+    _rows += rows;
+}
+
+/**
+ * @brief Appends all the rows of @a a.
+ *
+ * @a a must have the same descriptor and order as the file, and the same shape
+ * except along the row axis.
+ *
+ * @throw a np::error on failure.
+ */
+void npy_writer::append(const array& a)
+{
+    if(a.descr() != _descr)
+        throw error("descriptor does not match");
+
+    if(a.dimensions() != _row_shape.size() + 1)
+        throw error("size does not match");
+
+    if(a.dimensions() > 1 && a.fortran_order() != _fortran_order)
+        throw error("order does not match");
+
+    std::size_t axis = _fortran_order ? _row_shape.size() : 0;
+    std::size_t skip = _fortran_order ? 0 : 1;
+
+    for(std::size_t d = 0; d < _row_shape.size(); d++)
+    {
+        if(a.size(d + skip) != _row_shape[d])
+            throw error("shape does not match");
+    }
+
+    if(a.empty())
+        return;
+
+    append(a.data(), a.size(axis));
+}
+
+/**
+ * @brief Returns the number of rows written so far.
+ */
+std::size_t npy_writer::rows() const
+{
+    return _rows;
+}
+
+/**
+ * @brief Returns the size of a row in bytes.
+ */
+std::size_t npy_writer::row_size() const
+{
+    return _row_size;
+}
+
+/**
+ * @brief Returns the shape of the array written so far.
+ */
+shape_t npy_writer::shape() const
+{
+    return shape(_rows);
+}
+
+/**
+ * @brief Wether the file is still open for writing.
+ */
+bool npy_writer::is_open() const
+{
+    return _file != nullptr;
+}
+
+/**
+ * @brief Writes the final header and closes the file.
+ * @throw a np::error on failure.
+ */
+void npy_writer::close()
+{
+    if(!_file)
+        return;
+
+    std::FILE* f = _file;
+    _file = nullptr;
+
+    // Closes the file on failure, the last rows are only flushed by fclose
+    finally cleanup([&f](){ if(f) std::fclose(f); });
+
+    if(std::fseek(f, 0, SEEK_SET) != 0)
+        throw error(std::strerror(errno));
+
+    write_header(f, _rows);
+
+    if(std::fflush(f) != 0)
+        throw error(std::strerror(errno));
+
+    std::FILE* c = f;
+    f = nullptr;
+
+    if(std::fclose(c) != 0)
+        throw error(std::strerror(errno));
+}
+
+/**
+ * @brief Returns the shape of the array once it has @a rows rows.
+ */
+shape_t npy_writer::shape(std::size_t rows) const
+{
+    shape_t s = _row_shape;
+
+    if(_fortran_order)
+        s.push_back(rows);
+    else
+        s.insert(s.begin(), rows);
+
+    return s;
+}
+
+/**
+ * @brief Writes the header for @a rows rows at the current position of @a f.
+ *
+ * The first call reserves room for the longest possible row count, padded so
+ * the data is 64 bytes aligned as in array::save(), and the following calls
+ * pad their header to that same length.
+ */
+void npy_writer::write_header(std::FILE* f, std::size_t rows)
+{
+    if(_header_len == 0)
+    {
+        auto max = shape(std::numeric_limits<std::size_t>::max());
+        _header_len = array::make_header(_descr, max, _fortran_order).length() + 1;
+
+        // magic + version + len + header
+        while((6 + 2 + 4 + _header_len) % 64 != 0)
+            _header_len++;
+    }
+
+    std::string header = array::make_header(_descr, shape(rows), _fortran_order);
+    header.resize(_header_len - 1, ' ');
+    header.push_back('\n');
+
+    std::uint32_t len = byte_swap(static_cast<std::uint32_t>(_header_len), NativeEndian, LittleEndian);
+
+    file_io io(f);
+    io.write("\x93NUMPY\x02\x00", 8);
+    io.write(&len, 4);
+    io.write(header.data(), header.size());
+}
+
+}
@@ -0,0 +1,1986 @@
+#include <numpycpp/np_npz_archive.h>
+#include <numpycpp/np_npz_writer.h>
+#include <numpycpp/np_error.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <zip_file.hpp>
+
+namespace fs = std::filesystem;
+
+namespace np
+{
+
+namespace
+{
+
+// ====== Zip format ===========================================================
+
+
+
+constexpr std::uint32_t local_header_signature   = 0x04034b50;
+constexpr std::uint32_t central_header_signature = 0x02014b50;
+constexpr std::uint32_t end_of_central_signature = 0x06054b50;
+
+constexpr std::uint32_t zip64_end_of_central_signature = 0x06064b50;
+constexpr std::uint32_t zip64_locator_signature        = 0x07064b50;
+constexpr std::uint16_t zip64_extra_id                 = 0x0001;
+
+constexpr std::size_t local_header_size         = 30;
+constexpr std::size_t central_header_size       = 46;
+constexpr std::size_t end_of_central_size       = 22;
+constexpr std::size_t zip64_end_of_central_size = 56;
+constexpr std::size_t zip64_locator_size        = 20;
+
+constexpr std::uint16_t max16 = 0xffff;
+constexpr std::uint32_t max32 = 0xffffffff;
+
+constexpr std::uint16_t method_stored  = 0;
+constexpr std::uint16_t method_deflate = 8;
+
+constexpr std::size_t no_item = static_cast<std::size_t>(-1);
+
+/**
+ * @brief Reads a little endian value of type T at @a ptr
+ */
+template<class T>
+T read_le(const char* ptr)
+{
+    T v;
+    std::memcpy(&v, ptr, sizeof (T));
+    return byte_swap(v, LittleEndian, NativeEndian);
+}
+
+/**
+ * @brief Moves the position of @a file to the absolute @a offset, even past
+ * 2GB where fseek can't go on some platforms.
+ */
+void seek(std::FILE* file, std::uint64_t offset)
+{
+#ifdef _WIN32
+    int r = _fseeki64(file, static_cast<__int64>(offset), SEEK_SET);
+#else
+    int r = fseeko(file, static_cast<off_t>(offset), SEEK_SET);
+#endif
+
+    if(r != 0)
+        throw error(std::strerror(errno));
+}
+
+/**
+ * @brief Returns the size of @a file.
+ */
+std::uint64_t file_size(std::FILE* file)
+{
+#ifdef _WIN32
+    if(_fseeki64(file, 0, SEEK_END) != 0)
+        throw error(std::strerror(errno));
+
+    return static_cast<std::uint64_t>(_ftelli64(file));
+#else
+    if(fseeko(file, 0, SEEK_END) != 0)
+        throw error(std::strerror(errno));
+
+    return static_cast<std::uint64_t>(ftello(file));
+#endif
+}
+
+/**
+ * @brief Reads the ZIP64 extended information among the @a len bytes of extra
+ * fields at @a extra, for the fields of @a e saturated in its central header.
+ */
+void read_zip64_extra(const char* extra, std::size_t len, npz_archive::entry& e)
+{
+    std::size_t pos = 0;
+
+    while(pos + 4 <= len)
+    {
+        std::uint16_t id   = read_le<std::uint16_t>(extra + pos);
+        std::uint16_t size = read_le<std::uint16_t>(extra + pos + 2);
+
+        pos += 4;
+
+        if(pos + size > len)
+            break;
+
+        if(id == zip64_extra_id)
+        {
+            // Only the saturated fields are there, in this order
+            const char* p   = extra + pos;
+            const char* end = p + size;
+
+            for(std::uint64_t* v : {&e.size, &e.compressed_size, &e.offset})
+            {
+                if(*v != max32)
+                    continue;
+
+                if(end - p < 8)
+                    throw error(e.file_name + " - bad ZIP64 extra field");
+
+                *v = read_le<std::uint64_t>(p);
+                p += 8;
+            }
+
+            return;
+        }
+
+        pos += size;
+    }
+
+    if(e.size == max32 || e.compressed_size == max32 || e.offset == max32)
+        throw error(e.file_name + " - missing ZIP64 extra field");
+}
+
+/**
+ * @brief The member_source struct is the handle given to the IO helpers
+ * reading a member of the zip file.
+ */
+struct member_source
+{
+    std::FILE*                 file;
+    const npz_archive::entry&  entry;
+};
+
+/**
+ * @brief Opens the zip @a file and moves to the data of @a e.
+ */
+std::FILE* open_member(const fs::path& file, const npz_archive::entry& e)
+{
+    auto f = std::fopen(file.string().c_str(), "rb");
+
+    if(!f)
+        throw error("unable to open file");
+
+    try
+    {
+        char h[local_header_size];
+
+        seek(f, e.offset);
+        file_io(f).read(h, local_header_size);
+
+        if(read_le<std::uint32_t>(h) != local_header_signature)
+            throw error(e.file_name + " - bad local header");
+
+        std::uint16_t name_len  = read_le<std::uint16_t>(h + 26);
+        std::uint16_t extra_len = read_le<std::uint16_t>(h + 28);
+
+        seek(f, e.offset + local_header_size + name_len + extra_len);
+    }
+    catch(...)
+    {
+        std::fclose(f);
+        throw;
+    }
+
+    return f;
+}
+
+/**
+ * @brief Returns the position of the data of @a e in the mapped zip file
+ * @a data of @a size bytes.
+ */
+std::uint64_t member_data_offset(const char* data,
+                                 std::uint64_t size,
+                                 const npz_archive::entry& e)
+{
+    if(e.offset > size || size - e.offset < local_header_size)
+        throw error(e.file_name + " - bad local header");
+
+    const char* h = data + e.offset;
+
+    if(read_le<std::uint32_t>(h) != local_header_signature)
+        throw error(e.file_name + " - bad local header");
+
+    std::uint16_t name_len  = read_le<std::uint16_t>(h + 26);
+    std::uint16_t extra_len = read_le<std::uint16_t>(h + 28);
+
+    std::uint64_t offset = e.offset + local_header_size + name_len + extra_len;
+
+    if(offset > size || size - offset < e.compressed_size)
+        throw error(e.file_name + " - member out of the file");
+
+    return offset;
+}
+
+/**
+ * @brief The stored_reader class is an IO helper reading a member stored
+ * without compression, checking its CRC once fully read.
+ */
+class stored_reader
+{
+public:
+    stored_reader(member_source& src) :
+        file(src.file),
+        remaining(src.entry.size),
+        expected_crc(src.entry.crc)
+    {}
+
+    void read(void* ptr, std::size_t size)
+    {
+        if(size > remaining)
+            throw error("reading past the end of the member");
+
+        if(size == 0)
+            return;
+
+        file_io(file).read(ptr, size);
+
+        crc = mz_crc32(crc, static_cast<const mz_uint8*>(ptr), size);
+        remaining -= size;
+
+        if(remaining == 0 && checked && crc != expected_crc)
+            throw error("bad CRC");
+    }
+
+    void skip(std::size_t size)
+    {
+        if(size > remaining)
+            throw error("skipping past the end of the member");
+
+        // Skipped bytes are never read, so the CRC can't be checked anymore
+        file_io(file).skip(size);
+        remaining -= size;
+        checked = false;
+    }
+
+    std::size_t available()
+    {
+        return remaining;
+    }
+
+private:
+    std::FILE*    file;
+    std::uint64_t remaining;
+    std::uint32_t expected_crc;
+    mz_ulong      crc = MZ_CRC32_INIT;
+    bool          checked = true;
+};
+
+/**
+ * @brief The inflate_reader class is an IO helper inflating a deflated member
+ * straight into the destination buffer, checking its CRC once fully read.
+ */
+class inflate_reader
+{
+public:
+    inflate_reader(member_source& src) :
+        file(src.file),
+        input(64 * 1024),
+        compressed_remaining(src.entry.compressed_size),
+        remaining(src.entry.size),
+        expected_crc(src.entry.crc)
+    {
+        std::memset(&stream, 0, sizeof (stream));
+
+        if(mz_inflateInit2(&stream, -MZ_DEFAULT_WINDOW_BITS) != MZ_OK)
+            throw error("unable to initialize inflate");
+    }
+
+    ~inflate_reader()
+    {
+        mz_inflateEnd(&stream);
+    }
+
+    inflate_reader(const inflate_reader&) = delete;
+    inflate_reader& operator=(const inflate_reader&) = delete;
+
+    void read(void* ptr, std::size_t size)
+    {
+        if(size > remaining)
+            throw error("reading past the end of the member");
+
+        if(size == 0)
+            return;
+
+        auto out = static_cast<unsigned char*>(ptr);
+        std::size_t left = size;
+
+        while(left > 0)
+        {
+            // avail_out is only 32 bits
+            std::size_t step = std::min<std::size_t>(left, 1u << 30);
+
+            stream.next_out  = out;
+            stream.avail_out = static_cast<mz_uint>(step);
+
+            while(stream.avail_out > 0)
+            {
+                // The inflater may still hold decoded output once all the
+                // input is consumed, miniz hands it out over several calls
+                if(stream.avail_in == 0 && compressed_remaining > 0)
+                    refill();
+
+                int status = mz_inflate(&stream, MZ_NO_FLUSH);
+
+                if(status == MZ_STREAM_END)
+                {
+                    if(stream.avail_out > 0)
+                        throw error("unexpected end of compressed data");
+                }
+                else if(status == MZ_BUF_ERROR && stream.avail_in == 0)
+                    throw error("unexpected end of compressed data");
+                else if(status != MZ_OK)
+                    throw error("corrupted compressed data");
+            }
+
+            out  += step;
+            left -= step;
+        }
+
+        crc = mz_crc32(crc, static_cast<const mz_uint8*>(ptr), size);
+        remaining -= size;
+
+        if(remaining == 0 && crc != expected_crc)
+            throw error("bad CRC");
+    }
+
+    void skip(std::size_t size)
+    {
+        // Compressed data has to be inflated anyway
+        char buffer[4096];
+
+        while(size > 0)
+        {
+            std::size_t s = std::min(size, sizeof (buffer));
+            read(buffer, s);
+            size -= s;
+        }
+    }
+
+    std::size_t available()
+    {
+        return remaining;
+    }
+
+private:
+    void refill()
+    {
+        std::size_t s = std::min<std::uint64_t>(input.size(), compressed_remaining);
+        file_io(file).read(input.data(), s);
+
+        compressed_remaining -= s;
+        stream.next_in  = input.data();
+        stream.avail_in = static_cast<mz_uint>(s);
+    }
+
+private:
+    std::FILE*                 file;
+    mz_stream                  stream;
+    std::vector<unsigned char> input;
+    std::uint64_t              compressed_remaining;
+    std::uint64_t              remaining;
+    std::uint32_t              expected_crc;
+    mz_ulong                   crc = MZ_CRC32_INIT;
+};
+
+/**
+ * @brief Appends the little endian representation of @a v to @a buffer.
+ */
+template<class T>
+void write_le(std::string& buffer, T v)
+{
+    v = byte_swap(v, NativeEndian, LittleEndian);
+    buffer.append(reinterpret_cast<const char*>(&v), sizeof (T));
+}
+
+/**
+ * @brief Calls @a f for each index in [0, @a count) from @a threads threads,
+ * 0 meaning one per core.
+ *
+ * Exceptions are caught per index and the one of the lowest index is
+ * rethrown once every thread is done.
+ */
+template<class F>
+void parallel_for(std::size_t count, std::size_t threads, F f)
+{
+    if(threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    threads = std::min(threads, count);
+
+    std::vector<std::exception_ptr> errors(count);
+    std::atomic<std::size_t> next(0);
+
+    auto worker = [&]()
+    {
+        for(std::size_t i = next++; i < count; i = next++)
+        {
+            try
+            {
+                f(i);
+            }
+            catch(...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+
+    for(std::size_t t = 1; t < threads; t++)
+        pool.emplace_back(worker);
+
+    worker();
+
+    for(auto& t : pool)
+        t.join();
+
+    for(auto& e : errors)
+    {
+        if(e)
+            std::rethrow_exception(e);
+    }
+}
+
+}
+
+
+
+namespace details
+{
+
+
+
+// ====== Zip writer ===========================================================
+
+
+
+/**
+ * @brief The encoder class compresses a stream of bytes in raw deflate, as
+ * stored in zip files, or passes it through untouched at level 0. The output
+ * is handed to a sink as it comes.
+ */
+class encoder
+{
+public:
+    typedef std::function<void(const unsigned char*, std::size_t)> sink_t;
+
+    encoder(int level, sink_t sink) :
+        sink(std::move(sink)),
+        level(level)
+    {
+        if(level < 0 || level > 9)
+            throw error("compression level must be between 0 and 9");
+
+        if(level == 0)
+            return;
+
+        output.resize(64 * 1024);
+        std::memset(&stream, 0, sizeof (stream));
+
+        if(mz_deflateInit2(&stream, level, MZ_DEFLATED, -MZ_DEFAULT_WINDOW_BITS,
+                           9, MZ_DEFAULT_STRATEGY) != MZ_OK)
+            throw error("unable to initialize deflate");
+    }
+
+    ~encoder()
+    {
+        if(level != 0)
+            mz_deflateEnd(&stream);
+    }
+
+    encoder(const encoder&) = delete;
+    encoder& operator=(const encoder&) = delete;
+
+    std::uint16_t method() const
+    {
+        return level == 0 ? method_stored : method_deflate;
+    }
+
+    void write(const void* ptr, std::size_t size)
+    {
+        // crc32 of a null pointer is the initial value, not a no-op
+        if(size == 0)
+            return;
+
+        crc = mz_crc32(crc, static_cast<const mz_uint8*>(ptr), size);
+        total_in += size;
+
+        auto in = static_cast<const unsigned char*>(ptr);
+
+        if(level == 0)
+        {
+            sink(in, size);
+            total_out += size;
+            return;
+        }
+
+        while(size > 0)
+        {
+            // avail_in is only 32 bits
+            std::size_t step = std::min<std::size_t>(size, 1u << 30);
+
+            stream.next_in  = in;
+            stream.avail_in = static_cast<mz_uint>(step);
+
+            while(stream.avail_in > 0)
+                run(MZ_NO_FLUSH);
+
+            in   += step;
+            size -= step;
+        }
+    }
+
+    void finish()
+    {
+        if(level != 0)
+            while(run(MZ_FINISH) != MZ_STREAM_END);
+    }
+
+    std::uint32_t crc32() const
+    {
+        return static_cast<std::uint32_t>(crc);
+    }
+
+    std::uint64_t size() const
+    {
+        return total_in;
+    }
+
+    std::uint64_t compressed_size() const
+    {
+        return total_out;
+    }
+
+private:
+    int run(int flush)
+    {
+        stream.next_out  = output.data();
+        stream.avail_out = static_cast<mz_uint>(output.size());
+
+        int status = mz_deflate(&stream, flush);
+
+        if(status != MZ_OK && status != MZ_STREAM_END && status != MZ_BUF_ERROR)
+            throw error("compression failed");
+
+        std::size_t produced = output.size() - stream.avail_out;
+
+        if(produced > 0)
+        {
+            sink(output.data(), produced);
+            total_out += produced;
+        }
+
+        return status;
+    }
+
+private:
+    sink_t                     sink;
+    int                        level;
+    mz_stream                  stream;
+    std::vector<unsigned char> output;
+    mz_ulong                   crc       = MZ_CRC32_INIT;
+    std::uint64_t              total_in  = 0;
+    std::uint64_t              total_out = 0;
+};
+
+/**
+ * @brief The encoder_writer class is an IO helper saving an array through an
+ * encoder.
+ */
+class encoder_writer
+{
+public:
+    encoder_writer(encoder& e) : e(e) {}
+
+    void write(const void* ptr, std::size_t size)
+    {
+        e.write(ptr, size);
+    }
+
+private:
+    encoder& e;
+};
+
+/**
+ * @brief The packed_member struct holds a member encoded in memory, ready to
+ * be written in a zip file.
+ */
+struct packed_member
+{
+    npz_archive::entry         entry;
+    std::vector<unsigned char> data;
+};
+
+/**
+ * @brief Saves @a a as a npy file encoded in memory at @a level.
+ */
+packed_member pack(const std::string& name, const array& a, int level)
+{
+    packed_member m;
+    m.entry.name      = name;
+    m.entry.file_name = name + ".npy";
+
+    encoder enc(level, [&m](const unsigned char* ptr, std::size_t size)
+    {
+        m.data.insert(m.data.end(), ptr, ptr + size);
+    });
+
+    a.save<encoder_writer>(enc);
+    enc.finish();
+
+    m.entry.method          = enc.method();
+    m.entry.crc             = enc.crc32();
+    m.entry.size            = enc.size();
+    m.entry.compressed_size = enc.compressed_size();
+
+    return m;
+}
+
+/**
+ * @brief Returns wether a member of @a size bytes needs ZIP64 sizes in its
+ * local header, leaving room for deflate to grow incompressible data.
+ */
+bool needs_zip64(std::uint64_t size)
+{
+    return size + size / 16 + 1024 >= max32;
+}
+
+/**
+ * @brief The zip_writer class writes the members of a zip file one after the
+ * other, and its central directory on close(), switching to ZIP64 records
+ * where sizes or offsets need it.
+ *
+ * A member is either added at once or streamed between begin() and end().
+ * All the entries are dated 1980-01-01 so the same arrays always give the
+ * same file. After a failure in the middle of a member, the file can only be
+ * dropped.
+ */
+class zip_writer
+{
+public:
+    zip_writer(const fs::path& file) :
+        _file(std::fopen(file.string().c_str(), "wb"))
+    {
+        if(!_file)
+            throw error("unable to open file");
+    }
+
+    ~zip_writer()
+    {
+        if(_file)
+            std::fclose(_file);
+    }
+
+    zip_writer(const zip_writer&) = delete;
+    zip_writer& operator=(const zip_writer&) = delete;
+
+    std::size_t size() const
+    {
+        return _entries.size();
+    }
+
+    bool is_open() const
+    {
+        return _file != nullptr;
+    }
+
+    void add(const packed_member& m)
+    {
+        check_state();
+
+        npz_archive::entry e = m.entry;
+        e.offset = _offset;
+
+        bool zip64 = e.size >= max32 || e.compressed_size >= max32;
+
+        guard([&]()
+        {
+            write_local_header(e, zip64);
+            write(m.data.data(), m.data.size());
+        });
+
+        push(std::move(e));
+    }
+
+    void add(const std::string& name, const array& a, int level)
+    {
+        std::string preamble = array::make_preamble(a.descr(), a.shape(), a.fortran_order());
+
+        begin(name, preamble.size() + a.data_size(), level);
+        write_member(preamble.data(), preamble.size());
+        write_member(a.data(), a.data_size());
+        end();
+    }
+
+    /**
+     * @brief Starts a member of @a size bytes, before compression.
+     */
+    void begin(const std::string& name, std::uint64_t size, int level)
+    {
+        check_state();
+
+        if(_names.count(name))
+            throw error(name + " - already in the archive");
+
+        _current = npz_archive::entry();
+        _current.name      = name;
+        _current.file_name = name + ".npy";
+        _current.size      = size;
+        _current.offset    = _offset;
+        _current_zip64     = needs_zip64(size);
+
+        _encoder = std::make_unique<encoder>(level, [this](const unsigned char* ptr, std::size_t size)
+        {
+            write(ptr, size);
+        });
+
+        _current.method = _encoder->method();
+
+        guard([&]()
+        {
+            write_local_header(_current, _current_zip64);
+        });
+    }
+
+    void write_member(const void* ptr, std::size_t size)
+    {
+        if(!_encoder)
+            throw error("no member being written");
+
+        guard([&]()
+        {
+            _encoder->write(ptr, size);
+        });
+    }
+
+    /**
+     * @brief Finishes the member started by begin() and patches its local
+     * header with the CRC and sizes.
+     */
+    void end()
+    {
+        if(!_encoder)
+            throw error("no member being written");
+
+        guard([&]()
+        {
+            _encoder->finish();
+
+            if(_encoder->size() != _current.size)
+                throw error(_current.name + " - " + std::to_string(_encoder->size()) +
+                            " bytes written where " + std::to_string(_current.size) +
+                            " were expected");
+
+            _current.crc             = _encoder->crc32();
+            _current.compressed_size = _encoder->compressed_size();
+
+            if(!_current_zip64 && _current.compressed_size >= max32)
+                throw error(_current.name + " - member too big");
+
+            // crc, compressed size and size follow the version, flags, method,
+            // time and date
+            std::string patch;
+            write_le<std::uint32_t>(patch, _current.crc);
+
+            if(_current_zip64)
+            {
+                // sizes are in the ZIP64 extra field, after its id and size
+                seek(_file, _current.offset + 14);
+                file_io(_file).write(patch.data(), patch.size());
+
+                patch.clear();
+                write_le<std::uint64_t>(patch, _current.size);
+                write_le<std::uint64_t>(patch, _current.compressed_size);
+
+                seek(_file, _current.offset + local_header_size + _current.file_name.size() + 4);
+            }
+            else
+            {
+                write_le<std::uint32_t>(patch, static_cast<std::uint32_t>(_current.compressed_size));
+                write_le<std::uint32_t>(patch, static_cast<std::uint32_t>(_current.size));
+
+                seek(_file, _current.offset + 14);
+            }
+
+            file_io(_file).write(patch.data(), patch.size());
+            seek(_file, _offset);
+        });
+
+        _encoder.reset();
+        push(std::move(_current));
+    }
+
+    void close()
+    {
+        check_state();
+
+        std::uint64_t cd_offset = _offset;
+        std::string cd;
+
+        for(auto& e : _entries)
+        {
+            std::string extra;
+
+            if(e.size >= max32)
+                write_le<std::uint64_t>(extra, e.size);
+            if(e.compressed_size >= max32)
+                write_le<std::uint64_t>(extra, e.compressed_size);
+            if(e.offset >= max32)
+                write_le<std::uint64_t>(extra, e.offset);
+
+            std::uint16_t version = extra.empty() ? 20 : 45;
+
+            write_le<std::uint32_t>(cd, central_header_signature);
+            write_le<std::uint16_t>(cd, version);
+            write_le<std::uint16_t>(cd, version);
+            write_le<std::uint16_t>(cd, e.flags);
+            write_le<std::uint16_t>(cd, e.method);
+            write_le<std::uint16_t>(cd, 0);      // time 00:00:00
+            write_le<std::uint16_t>(cd, 0x0021); // date 1980-01-01
+            write_le<std::uint32_t>(cd, e.crc);
+            write_le<std::uint32_t>(cd, clamp32(e.compressed_size));
+            write_le<std::uint32_t>(cd, clamp32(e.size));
+            write_le<std::uint16_t>(cd, static_cast<std::uint16_t>(e.file_name.size()));
+            write_le<std::uint16_t>(cd, static_cast<std::uint16_t>(extra.empty() ? 0 : extra.size() + 4));
+            write_le<std::uint16_t>(cd, 0); // comment length
+            write_le<std::uint16_t>(cd, 0); // disk number
+            write_le<std::uint16_t>(cd, 0); // internal attributes
+            write_le<std::uint32_t>(cd, 0); // external attributes
+            write_le<std::uint32_t>(cd, clamp32(e.offset));
+            cd += e.file_name;
+
+            if(!extra.empty())
+            {
+                write_le<std::uint16_t>(cd, zip64_extra_id);
+                write_le<std::uint16_t>(cd, static_cast<std::uint16_t>(extra.size()));
+                cd += extra;
+            }
+        }
+
+        std::uint64_t count = _entries.size();
+        std::uint64_t zip64_offset = cd_offset + cd.size();
+
+        std::string eocd;
+
+        if(count >= max16 || cd.size() >= max32 || cd_offset >= max32)
+        {
+            write_le<std::uint32_t>(eocd, zip64_end_of_central_signature);
+            write_le<std::uint64_t>(eocd, zip64_end_of_central_size - 12);
+            write_le<std::uint16_t>(eocd, 45);
+            write_le<std::uint16_t>(eocd, 45);
+            write_le<std::uint32_t>(eocd, 0); // disk number
+            write_le<std::uint32_t>(eocd, 0); // central directory disk
+            write_le<std::uint64_t>(eocd, count);
+            write_le<std::uint64_t>(eocd, count);
+            write_le<std::uint64_t>(eocd, cd.size());
+            write_le<std::uint64_t>(eocd, cd_offset);
+
+            write_le<std::uint32_t>(eocd, zip64_locator_signature);
+            write_le<std::uint32_t>(eocd, 0); // ZIP64 end of central directory disk
+            write_le<std::uint64_t>(eocd, zip64_offset);
+            write_le<std::uint32_t>(eocd, 1); // number of disks
+        }
+
+        write_le<std::uint32_t>(eocd, end_of_central_signature);
+        write_le<std::uint16_t>(eocd, 0);
+        write_le<std::uint16_t>(eocd, 0);
+        write_le<std::uint16_t>(eocd, static_cast<std::uint16_t>(std::min<std::uint64_t>(count, max16)));
+        write_le<std::uint16_t>(eocd, static_cast<std::uint16_t>(std::min<std::uint64_t>(count, max16)));
+        write_le<std::uint32_t>(eocd, clamp32(cd.size()));
+        write_le<std::uint32_t>(eocd, clamp32(cd_offset));
+        write_le<std::uint16_t>(eocd, 0); // comment length
+
+        std::FILE* f = _file;
+        _file = nullptr;
+
+        finally cleanup([f](){ std::fclose(f); });
+
+        file_io io(f);
+        io.write(cd.data(), cd.size());
+        io.write(eocd.data(), eocd.size());
+
+        if(std::fflush(f) != 0)
+            throw error(std::strerror(errno));
+    }
+
+private:
+    void check_state() const
+    {
+        if(!_file)
+            throw error("archive is closed");
+
+        if(_failed)
+            throw error("archive is broken by a previous error");
+
+        if(_encoder)
+            throw error(_current.name + " - member is still being written");
+    }
+
+    /**
+     * @brief Calls @a f, marking the archive as broken if it throws.
+     */
+    template<class F>
+    void guard(F f)
+    {
+        try
+        {
+            f();
+        }
+        catch(...)
+        {
+            _failed = true;
+            _encoder.reset();
+            throw;
+        }
+    }
+
+    void push(npz_archive::entry e)
+    {
+        _names.insert(e.name);
+        _entries.push_back(std::move(e));
+    }
+
+    void write(const void* ptr, std::size_t size)
+    {
+        file_io(_file).write(ptr, size);
+        _offset += size;
+    }
+
+    void write_local_header(const npz_archive::entry& e, bool zip64)
+    {
+        std::string h;
+        write_le<std::uint32_t>(h, local_header_signature);
+        write_le<std::uint16_t>(h, zip64 ? 45 : 20);
+        write_le<std::uint16_t>(h, e.flags);
+        write_le<std::uint16_t>(h, e.method);
+        write_le<std::uint16_t>(h, 0);      // time 00:00:00
+        write_le<std::uint16_t>(h, 0x0021); // date 1980-01-01
+        write_le<std::uint32_t>(h, e.crc);
+        write_le<std::uint32_t>(h, zip64 ? max32 : static_cast<std::uint32_t>(e.compressed_size));
+        write_le<std::uint32_t>(h, zip64 ? max32 : static_cast<std::uint32_t>(e.size));
+        write_le<std::uint16_t>(h, static_cast<std::uint16_t>(e.file_name.size()));
+        write_le<std::uint16_t>(h, zip64 ? 20 : 0); // extra field length
+        h += e.file_name;
+
+        if(zip64)
+        {
+            write_le<std::uint16_t>(h, zip64_extra_id);
+            write_le<std::uint16_t>(h, 16);
+            write_le<std::uint64_t>(h, e.size);
+            write_le<std::uint64_t>(h, e.compressed_size);
+        }
+
+        write(h.data(), h.size());
+    }
+
+    static std::uint32_t clamp32(std::uint64_t v)
+    {
+        return static_cast<std::uint32_t>(std::min<std::uint64_t>(v, max32));
+    }
+
+private:
+    std::FILE*                      _file   = nullptr;
+    std::uint64_t                   _offset = 0;
+    std::vector<npz_archive::entry> _entries;
+    std::set<std::string>           _names;
+    std::unique_ptr<encoder>        _encoder;
+    npz_archive::entry              _current;
+    bool                            _current_zip64 = false;
+    bool                            _failed        = false;
+};
+
+}
+
+
+
+// ====== NPZ archive ==========================================================
+
+
+
+/**
+ * @brief Opens the npz @a file and reads its central directory.
+ * @throw a np::error on failure.
+ */
+npz_archive::npz_archive(const fs::path& file) :
+    _path(file)
+{
+    auto f = std::fopen(file.string().c_str(), "rb");
+
+    if(!f)
+        throw error("unable to open file");
+
+    finally cleanup([f](){ std::fclose(f); });
+
+    file_io io(f);
+
+    // The end of central directory record is at the very end, followed by a
+    // comment of at most 64KB
+    std::uint64_t size = file_size(f);
+    std::size_t tail_size = static_cast<std::size_t>(
+                std::min<std::uint64_t>(size, end_of_central_size + 0xffff));
+
+    std::vector<char> tail(tail_size);
+    seek(f, size - tail_size);
+    io.read(tail.data(), tail_size);
+
+    std::size_t eocd = tail_size;
+
+    for(std::size_t i = tail_size - std::min(tail_size, end_of_central_size) + 1; i-- > 0;)
+    {
+        if(read_le<std::uint32_t>(tail.data() + i) == end_of_central_signature)
+        {
+            eocd = i;
+            break;
+        }
+    }
+
+    if(tail_size < end_of_central_size || eocd == tail_size)
+        throw error("not a zip file");
+
+    const char* e = tail.data() + eocd;
+
+    std::uint64_t count     = read_le<std::uint16_t>(e + 10);
+    std::uint64_t cd_size   = read_le<std::uint32_t>(e + 12);
+    std::uint64_t cd_offset = read_le<std::uint32_t>(e + 16);
+
+    // A ZIP64 archive has a locator right before the end of central directory,
+    // pointing to the ZIP64 record that holds the real values
+    if(eocd >= zip64_locator_size &&
+       read_le<std::uint32_t>(e - zip64_locator_size) == zip64_locator_signature)
+    {
+        std::uint64_t record_offset = read_le<std::uint64_t>(e - zip64_locator_size + 8);
+
+        if(record_offset > size || size - record_offset < zip64_end_of_central_size)
+            throw error("corrupted ZIP64 end of central directory");
+
+        char record[zip64_end_of_central_size];
+        seek(f, record_offset);
+        io.read(record, zip64_end_of_central_size);
+
+        if(read_le<std::uint32_t>(record) != zip64_end_of_central_signature)
+            throw error("corrupted ZIP64 end of central directory");
+
+        count     = read_le<std::uint64_t>(record + 32);
+        cd_size   = read_le<std::uint64_t>(record + 40);
+        cd_offset = read_le<std::uint64_t>(record + 48);
+    }
+
+    if(cd_offset > size || size - cd_offset < cd_size)
+        throw error("corrupted central directory");
+
+    // Read the whole central directory at once
+    std::vector<char> cd(static_cast<std::size_t>(cd_size));
+    seek(f, cd_offset);
+    io.read(cd.data(), cd.size());
+
+    // Each entry takes at least a central header, don't trust count further
+    std::size_t capacity = static_cast<std::size_t>(
+                std::min<std::uint64_t>(count, cd.size() / central_header_size));
+
+    _entries.reserve(capacity);
+    _names.reserve(capacity);
+
+    std::size_t pos = 0;
+
+    for(std::uint64_t i = 0; i < count; i++)
+    {
+        if(pos + central_header_size > cd.size())
+            throw error("corrupted central directory");
+
+        const char* h = cd.data() + pos;
+
+        if(read_le<std::uint32_t>(h) != central_header_signature)
+            throw error("corrupted central directory");
+
+        std::uint16_t name_len    = read_le<std::uint16_t>(h + 28);
+        std::uint16_t extra_len   = read_le<std::uint16_t>(h + 30);
+        std::uint16_t comment_len = read_le<std::uint16_t>(h + 32);
+
+        if(pos + central_header_size + name_len + extra_len + comment_len > cd.size())
+            throw error("corrupted central directory");
+
+        entry en;
+        en.flags           = read_le<std::uint16_t>(h + 8);
+        en.method          = read_le<std::uint16_t>(h + 10);
+        en.crc             = read_le<std::uint32_t>(h + 16);
+        en.compressed_size = read_le<std::uint32_t>(h + 20);
+        en.size            = read_le<std::uint32_t>(h + 24);
+        en.offset          = read_le<std::uint32_t>(h + 42);
+        en.file_name.assign(h + central_header_size, name_len);
+
+        if(en.file_name.empty())
+            throw error("corrupted central directory");
+
+        read_zip64_extra(h + central_header_size + name_len, extra_len, en);
+
+        en.name = en.file_name;
+        if(en.name.size() > 4 && en.name.compare(en.name.size() - 4, 4, ".npy") == 0)
+            en.name.erase(en.name.size() - 4);
+
+        pos += central_header_size + name_len + extra_len + comment_len;
+
+        // Skip directories
+        if(en.file_name.back() == '/')
+            continue;
+
+        _lookup.emplace(en.name, _entries.size());
+        _names.push_back(en.name);
+        _entries.push_back(std::move(en));
+    }
+}
+
+/**
+ * @brief Opens the npz @a file, reads its central directory and maps it in
+ * memory according to @a mode.
+ *
+ * Arrays stored without compression are then loaded as views into the
+ * mapping.
+ *
+ * @throw a np::error on failure, or if @a mode is ReadWrite.
+ */
+npz_archive::npz_archive(const fs::path& file, MapMode mode) :
+    npz_archive(file)
+{
+    if(mode == ReadWrite)
+        throw error("npz archives can't be mapped ReadWrite");
+
+    _mapping = std::make_shared<mapped_file>(file, mode);
+}
+
+/**
+ * @brief Returns the path of the archive.
+ */
+const fs::path& npz_archive::path() const
+{
+    return _path;
+}
+
+/**
+ * @brief Returns wether the archive is mapped in memory.
+ */
+bool npz_archive::mapped() const
+{
+    return static_cast<bool>(_mapping);
+}
+
+/**
+ * @brief Returns the number of arrays in the archive.
+ */
+std::size_t npz_archive::size() const
+{
+    return _entries.size();
+}
+
+/**
+ * @brief Returns the names of the arrays, in the order of the archive.
+ */
+const std::vector<std::string>& npz_archive::names() const
+{
+    return _names;
+}
+
+/**
+ * @brief Returns wether the archive contains an array named @a name.
+ */
+bool npz_archive::contains(const std::string& name) const
+{
+    return _lookup.find(name) != _lookup.end();
+}
+
+/**
+ * @brief Returns the zip entry of the array named @a name.
+ * @throw a np::error if there is no such array.
+ */
+const npz_archive::entry& npz_archive::at(const std::string& name) const
+{
+    auto it = _lookup.find(name);
+
+    if(it == _lookup.end())
+        throw error(name + " - no such array");
+
+    return _entries[it->second];
+}
+
+/**
+ * @brief Reads only the header of the array named @a name.
+ *
+ * For compressed members only the first bytes are inflated.
+ *
+ * @throw a np::error on failure.
+ */
+header_info npz_archive::inspect(const std::string& name) const
+{
+    auto& e = at(name);
+
+    try
+    {
+        auto f = open_member(_path, e);
+        finally cleanup([f](){ std::fclose(f); });
+
+        member_source src {f, e};
+
+        if(e.method == method_stored)
+            return array::inspect<stored_reader>(src);
+        else if(e.method == method_deflate)
+            return array::inspect<inflate_reader>(src);
+        else
+            throw error("unsupported compression method " + std::to_string(e.method));
+    }
+    catch(std::exception& ex)
+    {
+        throw error(name + " - " + ex.what());
+    }
+}
+
+/**
+ * @brief Loads the array named @a name, its data is allocated from @a mr.
+ *
+ * The member is read or inflated directly in the array buffer. If the
+ * archive is mapped and the member is stored without compression, the
+ * returned array points directly into the mapping and @a mr is not used.
+ *
+ * @throw a np::error on failure.
+ */
+array npz_archive::load(const std::string& name, std::pmr::memory_resource* mr) const
+{
+    auto& e = at(name);
+
+    try
+    {
+        if(e.flags & 0x1)
+            throw error("encrypted members are not supported");
+
+        if(_mapping && e.method == method_stored)
+        {
+            std::uint64_t offset = member_data_offset(_mapping->data(),
+                                                      _mapping->size(),
+                                                      e);
+
+            return array::map(_mapping,
+                              static_cast<std::size_t>(offset),
+                              static_cast<std::size_t>(e.size));
+        }
+
+        auto f = open_member(_path, e);
+        finally cleanup([f](){ std::fclose(f); });
+
+        member_source src {f, e};
+
+        if(e.method == method_stored)
+            return array::load<stored_reader>(src, mr);
+        else if(e.method == method_deflate)
+            return array::load<inflate_reader>(src, mr);
+        else
+            throw error("unsupported compression method " + std::to_string(e.method));
+    }
+    catch(std::exception& ex)
+    {
+        throw error(name + " - " + ex.what());
+    }
+}
+
+
+
+// ====== NPZ writer ===========================================================
+
+
+
+/**
+ * @brief Starts streaming an array of @a shape elements described by
+ * @a descr in @a zip, see npz_writer::add_stream().
+ */
+npz_member_writer::npz_member_writer(details::zip_writer* zip,
+                                     descr_t descr,
+                                     shape_t shape,
+                                     bool fortran_order) :
+    _zip(zip),
+    _descr(std::move(descr)),
+    _shape(std::move(shape)),
+    _fortran_order(fortran_order)
+{
+    _row_size = _descr.stride();
+
+    std::size_t axis = _fortran_order ? _shape.size() - 1 : 0;
+
+    for(std::size_t d = 0; d < _shape.size(); d++)
+    {
+        if(d == axis)
+            _total_rows = _shape[d];
+        else
+            _row_size *= _shape[d];
+    }
+}
+
+/**
+ * @brief Takes over the member being written by @a other.
+ */
+npz_member_writer::npz_member_writer(npz_member_writer&& other) noexcept :
+    _zip(other._zip),
+    _descr(std::move(other._descr)),
+    _shape(std::move(other._shape)),
+    _fortran_order(other._fortran_order),
+    _rows(other._rows),
+    _total_rows(other._total_rows),
+    _row_size(other._row_size)
+{
+    other._zip = nullptr;
+}
+
+/**
+ * @brief Finishes the member if still open, errors are ignored. Call close()
+ * explicitely to get them.
+ */
+npz_member_writer::~npz_member_writer()
+{
+    try
+    {
+        close();
+    }
+    catch(...)
+    {
+    }
+}
+
+/**
+ * @brief Appends @a rows rows read from @a data, which must hold
+ * `rows * row_size()` bytes.
+ * @throw a np::error on failure, or past the last row.
+ */
+void npz_member_writer::append(const void* data, std::size_t rows)
+{
+    if(!_zip)
+        throw error("writer is closed");
+
+    if(rows > _total_rows - _rows)
+        throw error("too many rows");
+
+    _zip->write_member(data, rows * _row_size);
+    _rows += rows;
+}
+
+/**
+ * @brief Appends all the rows of @a a.
+ *
+ * @a a must have the same descriptor and order as the member, and the same
+ * shape except along the row axis.
+ *
+ * @throw a np::error on failure.
+ */
+void npz_member_writer::append(const array& a)
+{
+    if(a.descr() != _descr)
+        throw error("descriptor does not match");
+
+    if(a.dimensions() != _shape.size())
+        throw error("size does not match");
+
+    if(a.dimensions() > 1 && a.fortran_order() != _fortran_order)
+        throw error("order does not match");
+
+    std::size_t axis = _fortran_order ? _shape.size() - 1 : 0;
+
+    for(std::size_t d = 0; d < _shape.size(); d++)
+    {
+        if(d != axis && a.size(d) != _shape[d])
+            throw error("shape does not match");
+    }
+
+    if(a.empty())
+        return;
+
+    append(a.data(), a.size(axis));
+}
+
+/**
+ * @brief Returns the number of rows written so far.
+ */
+std::size_t npz_member_writer::rows() const
+{
+    return _rows;
+}
+
+/**
+ * @brief Returns the number of rows of the member.
+ */
+std::size_t npz_member_writer::total_rows() const
+{
+    return _total_rows;
+}
+
+/**
+ * @brief Returns the size of a row in bytes.
+ */
+std::size_t npz_member_writer::row_size() const
+{
+    return _row_size;
+}
+
+/**
+ * @brief Wether the member is still open for writing.
+ */
+bool npz_member_writer::is_open() const
+{
+    return _zip != nullptr;
+}
+
+/**
+ * @brief Finishes the member so the next one can be added.
+ * @throw a np::error on failure, or if some rows are missing, in which case
+ * the archive can't be completed.
+ */
+void npz_member_writer::close()
+{
+    if(!_zip)
+        return;
+
+    details::zip_writer* zip = _zip;
+    _zip = nullptr;
+
+    zip->end();
+}
+
+/**
+ * @brief Creates the npz @a file.
+ *
+ * Arrays are stored as is if @a level is 0, or deflated with that level, from
+ * 1 to 9.
+ *
+ * @throw a np::error on failure.
+ */
+npz_writer::npz_writer(const fs::path& file, int level) :
+    _level(level)
+{
+    if(level < 0 || level > 9)
+        throw error("compression level must be between 0 and 9");
+
+    _zip = std::make_unique<details::zip_writer>(file);
+}
+
+/**
+ * @brief Writes the central directory if still open, errors are ignored.
+ * Call close() explicitely to get them.
+ */
+npz_writer::~npz_writer()
+{
+    try
+    {
+        close();
+    }
+    catch(...)
+    {
+    }
+}
+
+/**
+ * @brief Writes @a a in the archive under @a name.
+ * @throw a np::error on failure, or if @a name is already in the archive.
+ */
+void npz_writer::add(const std::string& name, const array& a)
+{
+    _zip->add(name, a, _level);
+}
+
+/**
+ * @brief Starts writing an array named @a name of @a shape elements described
+ * by @a descr, whose rows are then appended through the returned
+ * npz_member_writer.
+ *
+ * No other array can be added before the returned writer is closed.
+ *
+ * @throw a np::error on failure, or if @a name is already in the archive.
+ */
+npz_member_writer npz_writer::add_stream(const std::string& name,
+                                         descr_t descr,
+                                         shape_t shape,
+                                         bool fortran_order)
+{
+    if(descr.empty())
+        throw error("empty descriptor");
+
+    if(shape.empty())
+        throw error("streamed arrays need at least one dimension");
+
+    std::string preamble = array::make_preamble(descr, shape, fortran_order);
+
+    // Only attached to the archive once the member is started
+    npz_member_writer m(nullptr, std::move(descr), std::move(shape), fortran_order);
+
+    _zip->begin(name, preamble.size() + m._total_rows * m._row_size, _level);
+    _zip->write_member(preamble.data(), preamble.size());
+
+    m._zip = _zip.get();
+
+    return m;
+}
+
+/**
+ * @brief Returns the number of arrays written so far.
+ */
+std::size_t npz_writer::size() const
+{
+    return _zip->size();
+}
+
+/**
+ * @brief Returns the compression level.
+ */
+int npz_writer::level() const
+{
+    return _level;
+}
+
+/**
+ * @brief Wether the archive is still open for writing.
+ */
+bool npz_writer::is_open() const
+{
+    return _zip->is_open();
+}
+
+/**
+ * @brief Writes the central directory and closes the file.
+ * @throw a np::error on failure, or if a member is still being written.
+ */
+void npz_writer::close()
+{
+    if(_zip->is_open())
+        _zip->close();
+}
+
+
+
+// ====== NPZ container ========================================================
+
+
+
+/**
+ * @brief Returns the number of arrays.
+ */
+std::size_t npz::size() const
+{
+    return _items.size();
+}
+
+/**
+ * @brief Returns wether there is no array.
+ */
+bool npz::empty() const
+{
+    return _items.empty();
+}
+
+/**
+ * @brief Makes room for @a count arrays in the index, so adding them never
+ * rehashes.
+ */
+void npz::reserve(std::size_t count)
+{
+    if(count * 2 > _index.size())
+        rehash(count);
+}
+
+/**
+ * @brief Removes all the arrays.
+ */
+void npz::clear()
+{
+    _items.clear();
+    std::fill(_index.begin(), _index.end(), no_item);
+}
+
+npz::iterator npz::begin()
+{
+    return _items.begin();
+}
+
+npz::iterator npz::end()
+{
+    return _items.end();
+}
+
+npz::const_iterator npz::begin() const
+{
+    return _items.begin();
+}
+
+npz::const_iterator npz::end() const
+{
+    return _items.end();
+}
+
+/**
+ * @brief Returns wether there is an array named @a name.
+ */
+bool npz::contains(std::string_view name) const
+{
+    return find(name) != end();
+}
+
+/**
+ * @brief Returns 1 if there is an array named @a name, 0 otherwise.
+ */
+std::size_t npz::count(std::string_view name) const
+{
+    return contains(name) ? 1 : 0;
+}
+
+/**
+ * @brief Returns the array named @a name, or end().
+ */
+npz::iterator npz::find(std::string_view name)
+{
+    if(_index.empty())
+        return end();
+
+    std::size_t i = _index[lookup(name)];
+    return i == no_item ? end() : begin() + i;
+}
+
+/**
+ * @brief Returns the array named @a name, or end().
+ */
+npz::const_iterator npz::find(std::string_view name) const
+{
+    if(_index.empty())
+        return end();
+
+    std::size_t i = _index[lookup(name)];
+    return i == no_item ? end() : begin() + i;
+}
+
+/**
+ * @brief Returns the array named @a name.
+ * @throw a np::error if there is no such array.
+ */
+array& npz::at(std::string_view name)
+{
+    auto it = find(name);
+
+    if(it == end())
+        throw error(std::string(name) + " - no such array");
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the array named @a name.
+ * @throw a np::error if there is no such array.
+ */
+const array& npz::at(std::string_view name) const
+{
+    auto it = find(name);
+
+    if(it == end())
+        throw error(std::string(name) + " - no such array");
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the array named @a name, adding an empty one at the end if
+ * there is none.
+ */
+array& npz::operator[](std::string_view name)
+{
+    auto it = find(name);
+
+    if(it != end())
+        return it->second;
+
+    return emplace(std::string(name), array()).first->second;
+}
+
+/**
+ * @brief Adds @a a at the end under @a name, unless there is already an array
+ * with that name.
+ * @return the array named @a name and wether @a a was added.
+ */
+std::pair<npz::iterator, bool> npz::emplace(std::string name, array a)
+{
+    if((_items.size() + 1) * 2 > _index.size())
+        rehash(_items.size() + 1);
+
+    std::size_t slot = lookup(name);
+
+    if(_index[slot] != no_item)
+        return {begin() + _index[slot], false};
+
+    _index[slot] = _items.size();
+    _items.emplace_back(std::move(name), std::move(a));
+
+    return {end() - 1, true};
+}
+
+/**
+ * @brief Adds @a a at the end under @a name, or replaces the array already
+ * there with that name, keeping its position.
+ * @return the array named @a name and wether @a a was added.
+ */
+std::pair<npz::iterator, bool> npz::insert_or_assign(std::string name, array a)
+{
+    auto it = find(name);
+
+    if(it == end())
+        return emplace(std::move(name), std::move(a));
+
+    it->second = std::move(a);
+    return {it, false};
+}
+
+/**
+ * @brief Removes the array named @a name, the following ones are moved back.
+ * @return the number of arrays removed, 0 or 1.
+ */
+std::size_t npz::erase(std::string_view name)
+{
+    auto it = find(name);
+
+    if(it == end())
+        return 0;
+
+    _items.erase(it);
+    rehash(_items.size());
+
+    return 1;
+}
+
+/**
+ * @brief Returns the slot of @a name in the index, or the empty slot where it
+ * would go. The index must not be empty.
+ */
+std::size_t npz::lookup(std::string_view name) const
+{
+    std::size_t mask = _index.size() - 1;
+    std::size_t slot = std::hash<std::string_view>()(name) & mask;
+
+    while(_index[slot] != no_item && _items[_index[slot]].first != name)
+        slot = (slot + 1) & mask;
+
+    return slot;
+}
+
+/**
+ * @brief Rebuilds the index with room for @a count arrays.
+ */
+void npz::rehash(std::size_t count)
+{
+    // A power of 2 at most half full, so probing stays short
+    std::size_t slots = std::max<std::size_t>(_index.size(), 16);
+
+    while(slots < count * 2)
+        slots *= 2;
+
+    _index.assign(slots, no_item);
+
+    for(std::size_t i = 0; i < _items.size(); i++)
+        _index[lookup(_items[i].first)] = i;
+}
+
+
+
+// ====== NPZ ==================================================================
+
+
+
+/**
+ * @brief Loads the give npz @a file, inflating its arrays from @a threads
+ * threads, 0 meaning one per core.
+ * @throw a np::error on failure.
+ */
+npz npz_load(const fs::path& file, std::size_t threads)
+{
+    npz_archive z(file);
+    std::vector<array> loaded(z.size());
+
+    parallel_for(z.size(), threads, [&](std::size_t i)
+    {
+        loaded[i] = z.load(z.names()[i]);
+    });
+
+    npz arrays;
+    arrays.reserve(z.size());
+
+    for(std::size_t i = 0; i < z.size(); i++)
+        arrays.emplace(z.names()[i], std::move(loaded[i]));
+
+    return arrays;
+}
+
+/**
+ * @brief Maps the given npz @a file in memory, see npz_archive.
+ */
+npz npz_map(const fs::path& file, MapMode mode)
+{
+    npz_archive z(file, mode);
+    npz arrays;
+    arrays.reserve(z.size());
+
+    for(auto& name : z.names())
+        arrays.emplace(name, z.load(name));
+
+    return arrays;
+}
+
+/**
+ * @brief Saves the given set of @a arrays into a npz @a file, deflating them
+ * from @a threads threads, 0 meaning one per core.
+ *
+ * Arrays are compressed concurrently but always written in the order of
+ * @a arrays, the file is the same whatever the number of threads.
+ * Only a few compressed arrays are held in memory at once.
+ *
+ * @throw a np::error on failure.
+ */
+void npz_save(const npz& arrays, const fs::path& file, std::size_t threads)
+{
+    std::vector<const npz::value_type*> members;
+    members.reserve(arrays.size());
+
+    for(auto& p : arrays)
+        members.push_back(&p);
+
+    auto pack_member = [&](std::size_t i)
+    {
+        try
+        {
+            // zlib's default level
+            return details::pack(members[i]->first, members[i]->second, 6);
+        }
+        catch(std::exception& ex)
+        {
+            throw error(members[i]->first + " - " + ex.what());
+        }
+    };
+
+    details::zip_writer w(file);
+
+    if(threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    threads = std::min(threads, members.size());
+
+    if(threads <= 1)
+    {
+        for(std::size_t i = 0; i < members.size(); i++)
+            w.add(pack_member(i));
+
+        w.close();
+        return;
+    }
+
+    // Workers compress ahead of the writer, by at most two members each
+    std::vector<details::packed_member> packed(members.size());
+    std::vector<std::exception_ptr> errors(members.size());
+    std::vector<char> ready(members.size(), false);
+    std::size_t written = 0;
+    std::size_t next = 0;
+    bool stop = false;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    auto worker = [&]()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while(true)
+        {
+            cv.wait(lock, [&](){ return stop || next < written + 2 * threads; });
+
+            if(stop || next >= members.size())
+                return;
+
+            std::size_t i = next++;
+            lock.unlock();
+
+            try
+            {
+                packed[i] = pack_member(i);
+            }
+            catch(...)
+            {
+                errors[i] = std::current_exception();
+            }
+
+            lock.lock();
+            ready[i] = true;
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+
+    finally join([&]()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+
+        cv.notify_all();
+
+        for(auto& t : pool)
+            t.join();
+    });
+
+    for(std::size_t t = 0; t < threads; t++)
+        pool.emplace_back(worker);
+
+    for(std::size_t i = 0; i < members.size(); i++)
+    {
+        details::packed_member m;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&](){ return ready[i] != 0; });
+
+            if(errors[i])
+                std::rethrow_exception(errors[i]);
+
+            m = std::move(packed[i]);
+        }
+
+        w.add(m);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            written = i + 1;
+        }
+
+        cv.notify_all();
+    }
+
+    w.close();
+}
+
+/**
+ * @brief Saves the given set of @a arrays into a npz @a file, like numpy's
+ * `savez_compressed`.
+ *
+ * Each array is streamed through deflate straight into the file, no copy of
+ * its data is made. @a level goes from 0, stored without compression, to 9,
+ * the best compression.
+ *
+ * @throw a np::error on failure.
+ */
+void npz_save_compressed(const npz& arrays, const fs::path& file, int level)
+{
+    npz_writer w(file, level);
+
+    for(auto& p : arrays)
+    {
+        try
+        {
+            w.add(p.first, p.second);
+        }
+        catch(std::exception& ex)
+        {
+            throw error(p.first + " - " + ex.what());
+        }
+    }
+
+    w.close();
+}
+
+}
@@ -4,6 +4,23 @@
 namespace np
 {
 
+/**
+ * @brief Moves the dimensions to a heap buffer of at least @a n dimensions.
+ */
+void shape_t::grow(size_type n)
+{
+    n = std::max(n, 2 * _capacity);
+
+    size_type* data = new size_type[n];
+    std::copy(_data, _data + _size, data);
+
+    if(_data != _inline)
+        delete[] _data;
+
+    _data     = data;
+    _capacity = n;
+}
+
 /**
  * @brief Returns a string representation of the shape (as a tuple)
  */
@@ -19,6 +36,29 @@ std::string shape_to_string(const shape_t& shape)
     return r;
 }
 
+/**
+ * @brief Returns the distance in elements between 2 consecutive elements
+ * along each axis of @a shape, in C order or Fortran order if
+ * @a fortran_order.
+ *
+ * The index of the element at the coordinates {c0, c1, ..., cn} is then
+ * c0 * s0 + c1 * s1 + ... + cn * sn.
+ */
+shape_t element_strides(const shape_t& shape, bool fortran_order)
+{
+    shape_t strides(shape.size());
+    std::size_t s = 1;
+
+    for(std::size_t i = 0; i < shape.size(); i++)
+    {
+        std::size_t d = fortran_order ? i : shape.size() - 1 - i;
+        strides[d] = s;
+        s *= shape[d];
+    }
+
+    return strides;
+}
+
 /**
  *  @brief Computes recursivly the index of an element in C ordering with the
  * given a @a shape and coordinates.
@@ -1,8 +1,8 @@
 #include <numpycpp/np_type_t.h>
 #include <numpycpp/np_error.h>
 
-#include <regex>
 #include <complex>
+#include <cstdint>
 
 namespace np
 {
@@ -31,28 +31,57 @@ bool type_t::operator!=(const type_t& o) const
 /**
  * @brief Parse a type string (like '<i4') and return a type_t representation
  */
-type_t type_t::from_string(const std::string& str)
+type_t type_t::from_string(std::string_view str)
 {
     if(str.empty())
         throw error("empty type");
 
     type_t r;
 
-    std::string t = str;
+    std::string_view t = str;
 
-    if((t.front() == '\'' && t.back() == '\'') || (t.front() == '"' && t.back() == '"'))
+    if(t.size() >= 2 &&
+       ((t.front() == '\'' && t.back() == '\'') || (t.front() == '"' && t.back() == '"')))
     {
-        t.erase(0, 1);
-        t.erase(t.size()-1, 1);
+        t.remove_prefix(1);
+        t.remove_suffix(1);
     }
 
-    std::regex check("^[<>|=][a-zA-Z](\\d+)(\\[[a-zA-Z]+\\])?$");
-    std::smatch m;
+    // Same as ^[<>|=][a-zA-Z](\d+)(\[[a-zA-Z]+\])?$
+    auto is_alpha = [](char c){ return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); };
+    auto is_digit = [](char c){ return c >= '0' && c <= '9'; };
 
-    if(!std::regex_match(t, m, check))
-        throw error("unsupported type " + t);
+    std::size_t i = 2;
+    std::size_t size = 0;
 
-    r._suffix = m.str(2);
+    if(t.size() < 3 || !is_alpha(t[1]) || !is_digit(t[2]))
+        throw error("unsupported type " + std::string(t));
+
+    while(i < t.size() && is_digit(t[i]))
+    {
+        std::size_t d = static_cast<std::size_t>(t[i++] - '0');
+
+        if(size > (SIZE_MAX - d) / 10)
+            throw error("unsupported type " + std::string(t));
+
+        size = size * 10 + d;
+    }
+
+    if(i < t.size())
+    {
+        std::size_t s = i;
+
+        if(t[i++] != '[' || i >= t.size() || !is_alpha(t[i]))
+            throw error("unsupported type " + std::string(t));
+
+        while(i < t.size() && is_alpha(t[i]))
+            ++i;
+
+        if(i != t.size() - 1 || t[i] != ']')
+            throw error("unsupported type " + std::string(t));
+
+        r._suffix = t.substr(s);
+    }
 
     switch(t[0])
     {
@@ -70,7 +99,7 @@ type_t type_t::from_string(const std::string& str)
         break;
 
     default:
-        throw error("unknown type " + t);
+        throw error("unknown type " + std::string(t));
     }
 
     r._ptype = t[1];
@@ -99,11 +128,11 @@ type_t type_t::from_string(const std::string& str)
     case 'S':
     case 'a':
     case 'V':
-        throw error("unsupported type " + t);
+        throw error("unsupported type " + std::string(t));
         break;
     }
 
-    r._size = std::stoul(m.str(1));
+    r._size = size;
 
     if(size_check)
     {
@@ -129,7 +158,7 @@ type_t type_t::from_string(const std::string& str)
                 break;
 
             default:
-                throw error("unsupported type " + t);
+                throw error("unsupported type " + std::string(t));
             }
             break;
 
@@ -153,7 +182,7 @@ type_t type_t::from_string(const std::string& str)
                 break;
 
             default:
-                throw error("unsupported type " + t);
+                throw error("unsupported type " + std::string(t));
             }
             break;
 
@@ -169,7 +198,7 @@ type_t type_t::from_string(const std::string& str)
                 break;
 
             default:
-                throw error("unsupported type " + t);
+                throw error("unsupported type " + std::string(t));
             }
             break;
 
@@ -185,18 +214,21 @@ type_t type_t::from_string(const std::string& str)
                 break;
 
             default:
-                throw error("unsupported type " + t);
+                throw error("unsupported type " + std::string(t));
             }
             break;
 
         case 'U':
+            if(r._size > SIZE_MAX / sizeof (char32_t))
+                throw error("unsupported type " + std::string(t));
+
             r._index = typeid(char32_t[]);
             r._strsize = r._size;
             r._size *= sizeof (char32_t);
             break;
 
         default:
-            throw error("unsupported type " + t);
+            throw error("unsupported type " + std::string(t));
         }
     }
 
@@ -1,6 +1,7 @@
 import numpy as np
 from random import random
 import os
+import zipfile
 
 # Create directory structure if needed
 test_dir  = os.path.dirname(os.path.realpath(__file__))
@@ -81,6 +82,22 @@ np.savez(
     string  = string
 )
 
+np.savez_compressed(
+    file=os.path.join(files_dir, 'npz-all-types-compressed.npz'),
+    int8    = int8,
+    int16   = int16,
+    int32   = int32,
+    int64   = int64,
+    uint8   = uint8,
+    uint16  = uint16,
+    uint32  = uint32,
+    uint64  = uint64,
+    float32 = float32,
+    float64 = float64,
+    bool    = boolean,
+    string  = string
+)
+
 # Creates some bigger files
 # File will be like weather resource data
 # let's say we have 20 years worth of data, 1 data point every 3 hours
@@ -122,6 +139,7 @@ for i in range(nb_points):
     npy[i]['wind_dir']  = wind_dir[i]
 
 np.save(os.path.join(files_dir, 'huge.npy'), npy)
+np.save(os.path.join(files_dir, 'huge-big-endian.npy'), npy.astype(npy.dtype.newbyteorder('>')))
 np.savez(
     file=os.path.join(files_dir, 'huge.npz'),
     timestamp = timestamp,
@@ -130,4 +148,33 @@ np.savez(
     wave_dir  = wave_dir,
     wind_sp   = wind_sp,
     wind_dir  = wind_dir
-)
\ No newline at end of file
+)
+
+# Save a npz with ZIP64 records, as numpy does for archives over 4GB, by
+# lowering the limit at which zipfile switches to them
+zip64_limit = zipfile.ZIP64_LIMIT
+zipfile.ZIP64_LIMIT = 0
+
+np.savez(
+    file=os.path.join(files_dir, 'npz-zip64.npz'),
+    int32   = int32,
+    float64 = float64,
+    string  = string
+)
+
+zipfile.ZIP64_LIMIT = zip64_limit
+
+# Save a structured array with an aligned dtype, its fields are padded like the
+# members of a C struct
+trade = np.zeros(100, dtype=np.dtype([
+    ('ts',    np.int64),
+    ('price', np.float32),
+    ('qty',   np.int32),
+    ('flag',  np.bool_)
+], align=True))
+trade['ts']    = np.arange(100) * 1000
+trade['price'] = np.arange(100) * 0.5
+trade['qty']   = np.arange(100) * -3
+trade['flag']  = np.arange(100) % 2 == 0
+
+np.save(os.path.join(files_dir, 'aligned.npy'), trade)
@@ -24,8 +24,12 @@ const fs::path NPY_STR = TYPE_DIR/"string.npy";
 
 const fs::path NPZ_F16   = FILES_DIR/"npz-with-f16.npz";
 const fs::path NPZ_TYPES = FILES_DIR/"npz-all-types.npz";
+const fs::path NPZ_TYPES_COMPRESSED = FILES_DIR/"npz-all-types-compressed.npz";
+const fs::path NPZ_ZIP64 = FILES_DIR/"npz-zip64.npz";
 const fs::path NPZ_HUGE  = FILES_DIR/"huge.npz";
 const fs::path NPY_HUGE  = FILES_DIR/"huge.npy";
+const fs::path NPY_HUGE_BE = FILES_DIR/"huge-big-endian.npy";
+const fs::path NPY_ALIGNED = FILES_DIR/"aligned.npy";
 
 const std::array<fs::path, 12> NPY_TYPE_FILES = {
     NPY_B, NPY_STR,
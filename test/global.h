@@ -3,6 +3,7 @@
 
 #include <array>
 #include <filesystem>
+#include <numpycpp/numpycpp.h>
 namespace fs = std::filesystem;
 
 extern const fs::path FILES_DIR;
@@ -29,9 +30,28 @@ extern const fs::path NPY_STR;
 
 extern const fs::path NPZ_F16;
 extern const fs::path NPZ_TYPES;
+extern const fs::path NPZ_TYPES_COMPRESSED;
+extern const fs::path NPZ_ZIP64;
 extern const fs::path NPZ_HUGE;
 extern const fs::path NPY_HUGE;
+extern const fs::path NPY_HUGE_BE;
+extern const fs::path NPY_ALIGNED;
 
 extern const std::array<fs::path, 12> NPY_TYPE_FILES;
 
+/**
+ * @brief Makes an array of the given shape where each element holds its
+ * flat index.
+ */
+template<class T>
+np::array make_iota(const np::shape_t& shape, bool fortran)
+{
+    np::array a(np::descr_t::make<T>(), shape, fortran);
+
+    for(std::size_t i = 0; i < a.size(); i++)
+        a[i].value<T>() = static_cast<T>(i);
+
+    return a;
+}
+
 #endif // GLOBAL_H
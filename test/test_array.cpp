@@ -1,3 +1,4 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include <catch2/catch_all.hpp>
 #include <numpycpp/numpycpp.h>
 
@@ -28,6 +29,25 @@ TEST_CASE("array unit test", "[array]")
         REQUIRE(c.size() == 27);
     }
 
+    SECTION("uninitialized")
+    {
+        np::array a(np::uninitialized, np::descr_t::make<float>(), {16, 16});
+
+        REQUIRE(!a.empty());
+        REQUIRE(a.size() == 256);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(a.data()) % np::array::data_alignment == 0);
+
+        np::array b(np::uninitialized, np::descr_t::make<double>(), {512, 512});
+
+        REQUIRE(np::array::alignment(b.data_size()) == np::array::huge_data_alignment);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(b.data()) % np::array::huge_data_alignment == 0);
+
+        np::array c(np::uninitialized, np::descr_t::make<int>(), {0});
+
+        REQUIRE(c.empty());
+        REQUIRE(c.data() == nullptr);
+    }
+
     SECTION("assignment")
     {
         np::array a;
@@ -302,3 +322,129 @@ TEST_CASE("array unit test", "[array]")
         }
     }
 }
+
+TEST_CASE("array strides and fixed rank indexing", "[array]")
+{
+    bool fortran = GENERATE(false, true);
+
+    np::array a(np::descr_t::make<int>(), {3, 4, 5, 6}, fortran);
+
+    REQUIRE(a.strides() == np::element_strides(a.shape(), fortran));
+    REQUIRE(a.strides() == (fortran ? np::shape_t{1, 3, 12, 60} : np::shape_t{120, 30, 6, 1}));
+
+    for(std::size_t i = 0; i < a.size(); i++)
+        a[i].value<int>() = static_cast<int>(i);
+
+    std::size_t mismatches = 0;
+
+    for(std::size_t i = 0; i < 3; i++)
+        for(std::size_t j = 0; j < 4; j++)
+            for(std::size_t k = 0; k < 5; k++)
+                for(std::size_t l = 0; l < 6; l++)
+                {
+                    std::size_t expected = fortran ? np::index_f_order(a.shape(), 0, i, j, k, l)
+                                                   : np::index_c_order(a.shape(), 0, i, j, k, l);
+
+                    if(a.index(i, j, k, l) != expected ||
+                       a.index<4>({i, j, k, l}) != expected ||
+                       a.index(std::vector<std::size_t>{i, j, k, l}) != expected ||
+                       a.at<4>({i, j, k, l}).value<int>() != static_cast<int>(expected))
+                        mismatches++;
+                }
+
+    REQUIRE(mismatches == 0);
+
+    // Missing trailing coordinates are 0
+    REQUIRE(a.index(2, 1) == a.index(2, 1, 0, 0));
+
+    REQUIRE_THROWS_AS(a.index(0, 0, 0, 0, 0), np::error);
+    REQUIRE_THROWS_AS(a.index<5>({0, 0, 0, 0, 0}), np::error);
+    REQUIRE_THROWS_AS(a.index(std::vector<std::size_t>{0, 0, 0}), np::error);
+    REQUIRE_THROWS_AS(a.at<4>({3, 4, 5, 6}), np::error);
+
+    // The strides follow the order and the copies
+    np::array b = a;
+    REQUIRE(b.strides() == a.strides());
+
+    b.to_fortran_order();
+    b.to_c_order();
+    REQUIRE(b.strides() == np::element_strides(b.shape(), false));
+}
+
+TEST_CASE("array at with a vector of coordinates", "[array]")
+{
+    bool fortran = GENERATE(false, true);
+
+    np::array a(np::descr_t::make<int>(), {2, 3}, fortran);
+
+    for(std::size_t i = 0; i < a.size(); i++)
+        a[i].value<int>() = static_cast<int>(i);
+
+    const np::array& c = a;
+
+    for(std::size_t i = 0; i < 2; i++)
+    {
+        for(std::size_t j = 0; j < 3; j++)
+        {
+            REQUIRE(a.at(std::vector<std::size_t>{i, j}).value<int>() == a.at(i, j).value<int>());
+            REQUIRE(c.at(std::vector<std::size_t>{i, j}).value<int>() == c.at(i, j).value<int>());
+        }
+    }
+}
+
+TEST_CASE("Benchmark random access", "[array]")
+{
+    np::array a(np::descr_t::make<int>(), {32, 32, 32, 32});
+
+    std::vector<std::array<std::size_t, 4>> coords(100000);
+    std::size_t seed = 12345;
+
+    for(auto& c : coords)
+    {
+        for(auto& x : c)
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            x = (seed >> 33) % 32;
+        }
+    }
+
+    BENCHMARK("index_c_order")
+    {
+        std::size_t sum = 0;
+
+        for(auto& c : coords)
+            sum += np::index_c_order(a.shape(), 0, c[0], c[1], c[2], c[3]);
+
+        return sum;
+    };
+
+    BENCHMARK("index(i, j, k, l)")
+    {
+        std::size_t sum = 0;
+
+        for(auto& c : coords)
+            sum += a.index(c[0], c[1], c[2], c[3]);
+
+        return sum;
+    };
+
+    BENCHMARK("index<4>")
+    {
+        std::size_t sum = 0;
+
+        for(auto& c : coords)
+            sum += a.index<4>(c);
+
+        return sum;
+    };
+
+    BENCHMARK("at<4>")
+    {
+        std::size_t sum = 0;
+
+        for(auto& c : coords)
+            sum += a.at<4>(c).value<int>();
+
+        return sum;
+    };
+}
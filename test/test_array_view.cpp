@@ -0,0 +1,157 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include "global.h"
+
+TEST_CASE("Array view", "[array][view]")
+{
+    bool fortran = GENERATE(false, true);
+
+    np::array a = make_iota<int>({4, 5, 6}, fortran);
+
+    SECTION("Whole array")
+    {
+        auto v = a.view();
+
+        REQUIRE(v.size() == a.size());
+        REQUIRE(v.shape() == a.shape());
+        REQUIRE(v.is_contiguous());
+
+        auto ai = a.begin();
+        for(auto it : v)
+        {
+            REQUIRE(it.value<int>() == ai.value<int>());
+            ++ai;
+        }
+
+        np::array c = v.contiguous();
+        REQUIRE(c.fortran_order() == fortran);
+        REQUIRE(std::memcmp(c.data(), a.data(), a.data_size()) == 0);
+    }
+
+    SECTION("Slices")
+    {
+        auto v = a.slice({{1, 3}, {std::nullopt, std::nullopt, 2}, {-1, 0, -2}});
+
+        REQUIRE(v.shape() == np::shape_t{2, 3, 3});
+        REQUIRE(!v.is_contiguous());
+
+        for(std::size_t i = 0; i < 2; i++)
+            for(std::size_t j = 0; j < 3; j++)
+                for(std::size_t k = 0; k < 3; k++)
+                    REQUIRE(v.at(i, j, k).value<int>() == a.at(1 + i, 2 * j, 5 - 2 * k).value<int>());
+
+        np::array c = v.contiguous();
+        REQUIRE(c.shape() == v.shape());
+
+        std::size_t n = 0;
+        for(auto it : v)
+            REQUIRE(it.value<int>() == c[n++].value<int>());
+
+        REQUIRE(n == v.size());
+
+        // Slicing a view again
+        auto w = v.slice({{1}, {1, 2}});
+        REQUIRE(w.shape() == np::shape_t{1, 1, 3});
+        REQUIRE(w.at(0, 0, 2).value<int>() == a.at(2, 2, 1).value<int>());
+
+        REQUIRE(a.slice({{10, 20}}).empty());
+        REQUIRE(a.slice({{10, 20}}).contiguous().size() == 0);
+        REQUIRE_THROWS_AS(a.slice({{0, 1, 0}}), np::error);
+        REQUIRE_THROWS_AS(a.slice({{}, {}, {}, {}}), np::error);
+    }
+
+    SECTION("Leading axis")
+    {
+        auto v = a.view()[2];
+
+        REQUIRE(v.shape() == np::shape_t{5, 6});
+        REQUIRE(v.at(3, 4).value<int>() == a.at(2, 3, 4).value<int>());
+
+        auto row = v[3];
+        REQUIRE(row.shape() == np::shape_t{6});
+        REQUIRE(row.at(4).value<int>() == a.at(2, 3, 4).value<int>());
+
+        row.at(4).value<int>() = -1;
+        REQUIRE(a.at(2, 3, 4).value<int>() == -1);
+
+        REQUIRE_THROWS_AS(row[0], np::error);
+        REQUIRE_THROWS_AS(v[5], np::error);
+    }
+
+    SECTION("Iterators")
+    {
+        auto v = a.slice({{}, {1, 4}, {std::nullopt, std::nullopt, -1}});
+        auto b = v.begin();
+        auto e = v.end();
+
+        REQUIRE(e - b == static_cast<std::ptrdiff_t>(v.size()));
+
+        auto it = b + 17;
+        REQUIRE(it.value<int>() == v.at_index(17).value<int>());
+        REQUIRE((--it).value<int>() == v.at_index(16).value<int>());
+        REQUIRE((it - 16) == b);
+
+        auto last = e;
+        --last;
+        REQUIRE(last.value<int>() == v.at_index(v.size() - 1).value<int>());
+
+        np::const_array_view cv = v;
+        REQUIRE(cv.begin().value<int>() == b.value<int>());
+
+        const np::array& ca = a;
+        REQUIRE(ca.slice({{1}}).size() == 3 * 5 * 6);
+    }
+}
+
+TEST_CASE("Structured array view", "[array][view]")
+{
+    np::array a = np::array::load(NPY_HUGE);
+
+    auto v = a.slice({{std::nullopt, std::nullopt, 100}});
+
+    REQUIRE(v.size() == (a.size() + 99) / 100);
+
+    std::size_t i = 0;
+    for(auto it : v)
+    {
+        REQUIRE(it.value<double>("wave_h") == a[i].value<double>("wave_h"));
+        i += 100;
+    }
+
+    std::vector<char> buffer(v.size() * a.descr().stride());
+    v.copy_to(buffer.data());
+
+    REQUIRE(std::memcmp(buffer.data() + a.descr().stride(), a[100].ptr(), a.descr().stride()) == 0);
+}
+
+TEST_CASE("Benchmark array view", "[array][view]")
+{
+    np::array a(np::descr_t::make<float>(), {2000, 512});
+    std::vector<float> window(64 * 512);
+
+    BENCHMARK("copy windows element by element")
+    {
+        for(std::size_t w = 0; w + 64 <= 2000; w += 32)
+        {
+            std::size_t n = 0;
+
+            for(std::size_t i = w; i < w + 64; i++)
+                for(std::size_t j = 0; j < 512; j++)
+                    window[n++] = a.at(i, j).value<float>();
+        }
+
+        return window[0];
+    };
+
+    BENCHMARK("copy windows from slices")
+    {
+        for(std::size_t w = 0; w + 64 <= 2000; w += 32)
+        {
+            auto v = a.slice({{static_cast<std::ptrdiff_t>(w), static_cast<std::ptrdiff_t>(w + 64)}});
+            v.copy_to(window.data());
+        }
+
+        return window[0];
+    };
+}
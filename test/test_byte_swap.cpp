@@ -0,0 +1,186 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include "global.h"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+
+namespace
+{
+
+std::vector<unsigned char> iota_bytes(std::size_t size)
+{
+    std::vector<unsigned char> v(size);
+    std::iota(v.begin(), v.end(), 0);
+    return v;
+}
+
+}
+
+TEST_CASE("Bulk byte swap", "[bytes]")
+{
+    std::size_t width = GENERATE(2, 4, 8, 16);
+    std::size_t count = GENERATE(1, 7, 33, 1001);
+
+    SECTION("Contiguous")
+    {
+        auto v = iota_bytes(width * count);
+        auto expected = v;
+
+        for(std::size_t i = 0; i < count; i++)
+            std::reverse(expected.begin() + i * width, expected.begin() + (i + 1) * width);
+
+        np::byte_swap(v.data(), width, count);
+        REQUIRE(v == expected);
+    }
+
+    SECTION("Strided")
+    {
+        std::size_t stride = width + 3;
+
+        auto v = iota_bytes(stride * count);
+        auto expected = v;
+
+        for(std::size_t i = 0; i < count; i++)
+            std::reverse(expected.begin() + i * stride, expected.begin() + i * stride + width);
+
+        np::byte_swap(v.data(), width, count, stride);
+        REQUIRE(v == expected);
+    }
+}
+
+TEST_CASE("Convert endianness", "[bytes][array]")
+{
+    SECTION("Structured")
+    {
+        np::array a = np::array::load(NPY_HUGE);
+        np::array b = a;
+
+        b.convert_to(np::OpositeEndian);
+
+        for(auto& field : b.descr())
+            REQUIRE(field.second.endianness() == np::OpositeEndian);
+
+        // Every element, not only the first one
+        for(std::size_t i = 0; i < a.size(); i += 997)
+        {
+            std::int64_t t = a[i].value<std::int64_t>("timestamp");
+            std::int64_t s;
+            std::memcpy(&s, b[i].ptr("timestamp"), sizeof (s));
+
+            REQUIRE(s == static_cast<std::int64_t>(np::byte_swap64(t)));
+        }
+
+        b.convert_to(np::NativeEndian);
+
+        REQUIRE(b.descr() == a.descr());
+        REQUIRE(std::memcmp(a.data(), b.data(), a.data_size()) == 0);
+    }
+
+    SECTION("Strings")
+    {
+        np::array a = np::array::load(NPY_STR);
+        np::array b = a;
+
+        b.convert_to(np::OpositeEndian);
+
+        const char32_t* sa = a.data_as<char32_t>();
+        const char32_t* sb = b.data_as<char32_t>();
+
+        REQUIRE(sb[0] == static_cast<char32_t>(np::byte_swap32(sa[0])));
+        REQUIRE(sb[a.size() * a.descr()[0].second.strsize() - 1] ==
+                static_cast<char32_t>(np::byte_swap32(sa[a.size() * a.descr()[0].second.strsize() - 1])));
+
+        b.convert_to(np::NativeEndian);
+        REQUIRE(std::memcmp(a.data(), b.data(), a.data_size()) == 0);
+    }
+}
+
+TEST_CASE("Benchmark byte swap", "[bytes][array]")
+{
+    np::array a = np::array::load(NPY_HUGE);
+
+    BENCHMARK("convert_to")
+    {
+        a.convert_to(np::OpositeEndian);
+        a.convert_to(np::NativeEndian);
+        return a.data();
+    };
+
+    BENCHMARK("per element and field")
+    {
+        for(int n = 0; n < 2; n++)
+        {
+            for(auto it : a)
+            {
+                for(auto& field : a.descr())
+                    np::byte_swap(it.ptr(field.first), field.second.size());
+            }
+        }
+
+        return a.data();
+    };
+
+    np::array f(np::uninitialized, np::descr_t::make<double>(), {a.size() * 6});
+
+    BENCHMARK("convert_to contiguous")
+    {
+        f.convert_to(np::OpositeEndian);
+        f.convert_to(np::NativeEndian);
+        return f.data();
+    };
+}
+
+TEST_CASE("Load converting endianness", "[bytes][array]")
+{
+    np::array native = np::array::load(NPY_HUGE);
+
+    SECTION("To native")
+    {
+        np::array a = np::array::load(NPY_HUGE_BE, np::load_options{np::NativeEndian});
+
+        REQUIRE(a.descr() == native.descr());
+        REQUIRE(a.shape() == native.shape());
+        REQUIRE(std::memcmp(a.data(), native.data(), a.data_size()) == 0);
+
+        std::ifstream stream(NPY_HUGE_BE, std::ios_base::in | std::ios_base::binary);
+        np::array b = np::array::load(stream, np::load_options{np::NativeEndian});
+
+        REQUIRE(std::memcmp(b.data(), native.data(), b.data_size()) == 0);
+    }
+
+    SECTION("Same as convert_to")
+    {
+        np::array a = np::array::load(NPY_HUGE, np::load_options{np::OpositeEndian});
+
+        native.convert_to(np::OpositeEndian);
+
+        REQUIRE(a.descr() == native.descr());
+        REQUIRE(std::memcmp(a.data(), native.data(), a.data_size()) == 0);
+    }
+
+    SECTION("No target")
+    {
+        np::array a = np::array::load(NPY_HUGE_BE, np::load_options{});
+
+        for(auto& field : a.descr())
+            REQUIRE(field.second.endianness() == np::BigEndian);
+    }
+}
+
+TEST_CASE("Benchmark load big endian", "[bytes][array]")
+{
+    BENCHMARK("load then convert_to")
+    {
+        auto a = np::array::load(NPY_HUGE_BE);
+        a.convert_to();
+        return a;
+    };
+
+    BENCHMARK("load converting")
+    {
+        return np::array::load(NPY_HUGE_BE, np::load_options{np::NativeEndian});
+    };
+}
@@ -0,0 +1,138 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include "global.h"
+
+namespace
+{
+
+struct weather
+{
+    std::int64_t timestamp;
+    double       wave_h;
+    double       wave_p;
+    double       wave_dir;
+    double       wind_sp;
+    double       wind_dir;
+};
+
+struct wave
+{
+    std::int64_t timestamp;
+    double       wave_h;
+};
+
+}
+
+namespace np
+{
+
+template<>
+struct record_traits<weather>
+{
+    static descr_t descr()
+    {
+        return descr_t::make(field_t::make<std::int64_t>("timestamp"),
+                             field_t::make<double>("wave_h"),
+                             field_t::make<double>("wave_p"),
+                             field_t::make<double>("wave_dir"),
+                             field_t::make<double>("wind_sp"),
+                             field_t::make<double>("wind_dir"));
+    }
+};
+
+template<>
+struct record_traits<wave>
+{
+    static descr_t descr()
+    {
+        return descr_t::make(field_t::make<std::int64_t>("timestamp"),
+                             field_t::make<double>("wave_h"));
+    }
+};
+
+}
+
+TEST_CASE("Field ref", "[array][field]")
+{
+    np::array a = np::array::load(NPY_HUGE);
+
+    auto ts = a.field<std::int64_t>("timestamp");
+    auto wind = a.field<double>("wind_sp");
+
+    REQUIRE(ts.size() == a.size());
+    REQUIRE(ts.stride() == a.descr().stride());
+    REQUIRE(wind.end() - wind.begin() == static_cast<std::ptrdiff_t>(a.size()));
+
+    std::size_t i = 0;
+    std::size_t mismatches = 0;
+
+    for(double w : wind)
+    {
+        if(w != a[i].value<double>("wind_sp") ||
+           ts[i] != a[i].value<std::int64_t>("timestamp"))
+            mismatches++;
+
+        i++;
+    }
+
+    REQUIRE(mismatches == 0);
+
+    wind[3] = 12.5;
+    REQUIRE(a[3].value<double>("wind_sp") == 12.5);
+
+    const np::array& c = a;
+    REQUIRE(c.field<double>("wind_sp")[3] == 12.5);
+
+    REQUIRE_THROWS_AS(a.field<float>("wind_sp"), np::error);
+    REQUIRE_THROWS_AS(a.field<double>("not_a_field"), np::error);
+
+    SECTION("Records")
+    {
+        auto records = a.as_records<weather>();
+
+        REQUIRE(records.size() == a.size());
+        REQUIRE(records[3].wind_sp == 12.5);
+        REQUIRE(records[10].timestamp == ts[10]);
+
+        REQUIRE_THROWS_AS(a.as_records<wave>(), np::error);
+
+        a.convert_to(np::OpositeEndian);
+        REQUIRE_THROWS_AS(a.as_records<weather>(), np::error);
+    }
+}
+
+TEST_CASE("Benchmark field ref", "[array][field]")
+{
+    np::array a = np::array::load(NPY_HUGE);
+
+    BENCHMARK("value by name")
+    {
+        double sum = 0;
+
+        for(auto it : a)
+            sum += it.value<double>("wave_h");
+
+        return sum;
+    };
+
+    BENCHMARK("field ref")
+    {
+        double sum = 0;
+
+        for(double d : a.field<double>("wave_h"))
+            sum += d;
+
+        return sum;
+    };
+
+    BENCHMARK("records")
+    {
+        double sum = 0;
+
+        for(auto& r : a.as_records<weather>())
+            sum += r.wave_h;
+
+        return sum;
+    };
+}
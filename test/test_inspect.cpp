@@ -0,0 +1,38 @@
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include <fstream>
+#include "global.h"
+
+TEST_CASE("Inspect simple file", "[npy][inspect]")
+{
+    for(const auto& f : NPY_TYPE_FILES)
+    {
+        np::header_info info = np::array::inspect(f);
+        np::array a = np::array::load(f);
+
+        REQUIRE(info.shape == a.shape());
+        REQUIRE(info.descr.to_string() == a.descr().to_string());
+        REQUIRE(info.fortran_order == a.fortran_order());
+        REQUIRE(info.data_offset == fs::file_size(f) - a.data_size());
+
+        std::ifstream stream(f, std::ios_base::in | std::ios_base::binary);
+        REQUIRE(np::array::inspect(stream).data_offset == info.data_offset);
+    }
+
+    REQUIRE_THROWS(np::array::inspect(NPY_F16));
+}
+
+TEST_CASE("Inspect directory", "[npy][inspect]")
+{
+    std::vector<std::pair<fs::path, std::string>> errors;
+    auto infos = np::array::inspect_directory(TYPE_DIR, 4, &errors);
+
+    REQUIRE(infos.size() == NPY_TYPE_FILES.size());
+    REQUIRE(errors.size() == 1);
+    REQUIRE(errors[0].first == NPY_F16);
+
+    for(auto& p : infos)
+        REQUIRE(p.second.shape == np::shape_t{5});
+
+    REQUIRE_THROWS(np::array::inspect_directory(TYPE_DIR));
+}
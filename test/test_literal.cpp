@@ -0,0 +1,156 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include <regex>
+#include <unordered_map>
+
+using np::details::literal;
+
+namespace
+{
+
+const std::string HEADER = "{'descr': [('timestamp', '<i8'), ('wave_h', '<f8'), "
+                           "('wave_p', '<f8'), ('wave_dir', '<f8'), "
+                           "('wind_sp', '<f8'), ('wind_dir', '<f8')], "
+                           "'fortran_order': False, 'shape': (58400,), }"
+                           "                                          \n";
+
+// The regex based parsing used before the literal parser, kept as a reference
+// for the benchmark.
+std::size_t regex_parse(const std::string& header)
+{
+    std::regex dict ("'([a-zA-Z0-9_-]+)':\\s*('[|=<>][a-zA-Z]\\d+(\\[[a_zA-Z]+\\])?'|\\[.*\\]|True|False|\\(.*\\))");
+    std::unordered_map<std::string, std::string> header_dict;
+
+    auto dict_begin = std::sregex_iterator(header.begin(), header.end(), dict);
+    auto dict_end = std::sregex_iterator();
+
+    for(auto it = dict_begin; it != dict_end; ++it)
+        header_dict.emplace(it->str(1), it->str(2));
+
+    std::string shape_str = header_dict.at("shape");
+    std::regex shape_value("\\d+");
+    auto sbegin = std::sregex_iterator(shape_str.begin(), shape_str.end(), shape_value);
+    auto send   = std::sregex_iterator();
+
+    std::size_t size = 1;
+    for(auto it = sbegin; it != send; ++it)
+        size *= std::stoul(it->str());
+
+    std::regex field("\\('([a-zA-Z0-9_-]+)',\\s*'([<>|=][a-zA-Z]\\d+)'\\)");
+    std::string descr_str = header_dict.at("descr");
+    auto fbegin = std::sregex_iterator(descr_str.begin(), descr_str.end(), field);
+    auto fend   = std::sregex_iterator();
+
+    std::regex check("^[<>|=][a-zA-Z](\\d+)(\\[[a-zA-Z]+\\])?$");
+    std::smatch m;
+
+    std::size_t stride = 0;
+    for(auto it = fbegin; it != fend; ++it)
+    {
+        std::string t = it->str(2);
+        if(std::regex_match(t, m, check))
+            stride += std::stoul(m.str(1));
+    }
+
+    return size * stride;
+}
+
+std::size_t literal_parse(const std::string& header)
+{
+    auto dict = literal::parse(header);
+    auto& shape = dict["shape"];
+
+    std::size_t size = 1;
+    for(std::size_t i = 0; i < shape.size(); i++)
+        size *= shape[i].integer();
+
+    std::size_t stride = 0;
+    auto& descr = dict["descr"];
+    for(std::size_t i = 0; i < descr.size(); i++)
+        stride += np::type_t::from_string(descr[i][1].string()).size();
+
+    return size * stride;
+}
+
+}
+
+TEST_CASE("literal unit test", "[literal]")
+{
+    SECTION("scalars")
+    {
+        REQUIRE(literal::parse("True").boolean());
+        REQUIRE_FALSE(literal::parse("False").boolean());
+        REQUIRE(literal::parse("None").is(literal::None));
+        REQUIRE(literal::parse("123").integer() == 123);
+        REQUIRE(literal::parse("-12").integer() == -12);
+        REQUIRE(literal::parse("3L").integer() == 3);
+        REQUIRE(literal::parse("9223372036854775807").integer() == INT64_MAX);
+        REQUIRE(literal::parse("-9223372036854775807").integer() == -INT64_MAX);
+        REQUIRE(literal::parse("'<f8'").string() == "<f8");
+        REQUIRE(literal::parse("\"<f8\"").string() == "<f8");
+
+        REQUIRE_THROWS(literal::parse(""));
+        REQUIRE_THROWS(literal::parse("true"));
+        REQUIRE_THROWS(literal::parse("'unterminated"));
+        REQUIRE_THROWS(literal::parse("12 13"));
+        REQUIRE_THROWS(literal::parse("9223372036854775808"));
+        REQUIRE_THROWS(literal::parse("(99999999999999999999999,)"));
+
+        REQUIRE(literal::parse(std::string(32, '[') + std::string(32, ']')).size() == 1);
+        REQUIRE_THROWS_AS(literal::parse(std::string(33, '[') + std::string(33, ']')), np::error);
+        REQUIRE_THROWS_AS(literal::parse(std::string(1000000, '[')), np::error);
+        REQUIRE_THROWS(literal::parse("True").integer());
+    }
+
+    SECTION("containers")
+    {
+        auto t = literal::parse("(3, 4,)");
+
+        REQUIRE(t.is(literal::Tuple));
+        REQUIRE(t.size() == 2);
+        REQUIRE(t[0].integer() == 3);
+        REQUIRE(t[1].integer() == 4);
+        REQUIRE_THROWS(t[2]);
+
+        REQUIRE(literal::parse("()").size() == 0);
+        REQUIRE(literal::parse("[('a', '<i4'), ('b', '<f8')]")[1][0].string() == "b");
+
+        REQUIRE_THROWS(literal::parse("(3, 4"));
+        REQUIRE_THROWS(literal::parse("[3 4]"));
+    }
+
+    SECTION("header")
+    {
+        auto d = literal::parse(HEADER);
+
+        REQUIRE(d.is(literal::Dict));
+        REQUIRE(d.size() == 3);
+        REQUIRE(d.key(0) == "descr");
+        REQUIRE(d["descr"].size() == 6);
+        REQUIRE(d["shape"][0].integer() == 58400);
+        REQUIRE_FALSE(d["fortran_order"].boolean());
+        REQUIRE(d.find("test") == nullptr);
+        REQUIRE_THROWS(d["test"]);
+
+        REQUIRE(regex_parse(HEADER) == literal_parse(HEADER));
+    }
+}
+
+TEST_CASE("Benchmark header parsing", "[literal]")
+{
+    BENCHMARK("regex")
+    {
+        return regex_parse(HEADER);
+    };
+
+    BENCHMARK("literal")
+    {
+        return literal_parse(HEADER);
+    };
+
+    BENCHMARK("descr_t::from_string")
+    {
+        return np::descr_t::from_string("[('timestamp', '<i8'), ('wave_h', '<f8'), ('wave_p', '<f8')]");
+    };
+}
@@ -0,0 +1,66 @@
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include <fstream>
+#include "global.h"
+
+TEST_CASE("Load rows", "[npy][slice]")
+{
+    np::array huge = np::array::load(NPY_HUGE);
+    np::array rows = np::array::load_rows(NPY_HUGE, 100, 50);
+
+    REQUIRE(rows.dimensions() == 1);
+    REQUIRE(rows.size() == 50);
+    REQUIRE(std::memcmp(rows.data(), huge[100].ptr(), rows.data_size()) == 0);
+
+    std::ifstream stream(NPY_HUGE, std::ios_base::in | std::ios_base::binary);
+    np::array srows = np::array::load_rows(stream, 100, 50);
+
+    REQUIRE(std::memcmp(srows.data(), rows.data(), rows.data_size()) == 0);
+
+    REQUIRE(np::array::load_rows(NPY_HUGE, huge.size(), 0).empty());
+    REQUIRE_THROWS(np::array::load_rows(NPY_HUGE, huge.size() - 1, 2));
+}
+
+TEST_CASE("Load slice", "[npy][slice]")
+{
+    bool fortran_order = GENERATE(false, true);
+
+    np::array a(np::descr_t::make<int>(), {5, 4, 3}, fortran_order);
+
+    for(std::size_t x = 0; x < 5; x++)
+        for(std::size_t y = 0; y < 4; y++)
+            for(std::size_t z = 0; z < 3; z++)
+                a.at(x, y, z).value<int>() = x * 100 + y * 10 + z;
+
+    auto dst = std::filesystem::temp_directory_path() / "test_slice.npy";
+    a.save(dst);
+
+    np::shape_t start  = {1, 1, 1};
+    np::shape_t extent = {3, 2, 2};
+
+    np::array s = np::array::load_slice(dst, start, extent);
+
+    REQUIRE(s.shape() == extent);
+    REQUIRE(s.fortran_order() == fortran_order);
+
+    for(std::size_t x = 0; x < 3; x++)
+        for(std::size_t y = 0; y < 2; y++)
+            for(std::size_t z = 0; z < 2; z++)
+                REQUIRE(s.at(x, y, z).value<int>() == static_cast<int>((x + 1) * 100 + (y + 1) * 10 + z + 1));
+
+    np::array r = np::array::load_rows(dst, 1, 2);
+
+    if(fortran_order)
+    {
+        REQUIRE(r.shape() == np::shape_t{5, 4, 2});
+        REQUIRE(r.at(4, 3, 0).value<int>() == 431);
+    }
+    else
+    {
+        REQUIRE(r.shape() == np::shape_t{2, 4, 3});
+        REQUIRE(r.at(0, 3, 2).value<int>() == 132);
+    }
+
+    REQUIRE_THROWS(np::array::load_slice(dst, {0, 0}, {1, 1}));
+    REQUIRE_THROWS(np::array::load_slice(dst, {4, 0, 0}, {2, 1, 1}));
+}
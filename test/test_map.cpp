@@ -0,0 +1,71 @@
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include "global.h"
+
+TEST_CASE("Map simple file", "[npy][map]")
+{
+    for(const auto& f : NPY_TYPE_FILES)
+    {
+        np::array l = np::array::load(f);
+        np::array m = np::array::map(f);
+
+        REQUIRE(m.mapped());
+        REQUIRE_FALSE(l.mapped());
+        REQUIRE(m.shape() == l.shape());
+        REQUIRE(m.descr().to_string() == l.descr().to_string());
+        REQUIRE(m.data_size() == l.data_size());
+        REQUIRE(std::memcmp(m.data(), l.data(), l.data_size()) == 0);
+
+        np::array c = m;
+
+        REQUIRE(c.mapped());
+        REQUIRE(c.data() == m.data());
+    }
+}
+
+TEST_CASE("Map huge file", "[npy][map]")
+{
+    np::array huge = np::array::map(NPY_HUGE);
+
+    REQUIRE(huge.dimensions() == 1);
+    REQUIRE(huge.descr().stride() == 48);
+    REQUIRE(huge[1].value<std::int64_t>("timestamp") == 3 * 3600);
+}
+
+TEST_CASE("Map modes", "[npy][map]")
+{
+    auto dst = std::filesystem::temp_directory_path() / "test_map.npy";
+
+    np::array a(np::descr_t::make<int>(), {3, 3});
+    a.save(dst);
+
+    {
+        np::array cow = np::array::map(dst, np::CopyOnWrite);
+        cow[0].value<int>() = 123;
+
+        REQUIRE(np::array::load(dst)[0].value<int>() == 0);
+    }
+
+    {
+        np::array rw = np::array::map(dst, np::ReadWrite);
+        rw[0].value<int>() = 123;
+    }
+
+    REQUIRE(np::array::load(dst)[0].value<int>() == 123);
+
+    {
+        np::array ro = np::array::map(dst, np::ReadOnly);
+
+        REQUIRE_THROWS_AS(ro.convert_to(np::OpositeEndian), np::error);
+        REQUIRE_THROWS_AS(ro.to_fortran_order(), np::error);
+        REQUIRE_THROWS_AS(ro.to_c_order(), np::error);
+        REQUIRE(ro[0].value<int>() == 123);
+
+        // Copies share the mapping, a contiguous copy of its view owns its data
+        np::array shared = ro;
+        REQUIRE_THROWS_AS(shared.convert_to(np::OpositeEndian), np::error);
+
+        np::array owned = ro.view().contiguous();
+        REQUIRE_NOTHROW(owned.convert_to(np::OpositeEndian));
+    }
+}
@@ -0,0 +1,102 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include "global.h"
+
+TEST_CASE("Memory resource", "[array][pmr]")
+{
+    std::pmr::monotonic_buffer_resource arena(1024 * 1024);
+
+    np::array a(np::descr_t::make<int>(), {3, 3}, false, &arena);
+
+    REQUIRE(a.resource() == &arena);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(a.data()) % np::array::data_alignment == 0);
+
+    for(int i = 0; i < 9; i++)
+        a[i].value<int>() = i;
+
+    SECTION("copy")
+    {
+        np::array b = a;
+
+        REQUIRE(b.resource() == std::pmr::get_default_resource());
+        REQUIRE(b.data() != a.data());
+        REQUIRE(b[4].value<int>() == 4);
+
+        np::array c(a, &arena);
+
+        REQUIRE(c.resource() == &arena);
+        REQUIRE(c[4].value<int>() == 4);
+
+        b = c;
+
+        REQUIRE(b.resource() == std::pmr::get_default_resource());
+    }
+
+    SECTION("move")
+    {
+        const char* data = a.data();
+
+        np::array b(std::move(a));
+
+        REQUIRE(b.resource() == &arena);
+        REQUIRE(b.data() == data);
+
+        np::array c(&arena);
+        c = std::move(b);
+
+        REQUIRE(c.data() == data);
+
+        np::array d;
+        d = std::move(c);
+
+        REQUIRE(d.resource() == std::pmr::get_default_resource());
+        REQUIRE(d.data() != data);
+        REQUIRE(d[8].value<int>() == 8);
+    }
+
+    SECTION("load")
+    {
+        np::array l = np::array::load(NPY_I32, &arena);
+
+        REQUIRE(l.resource() == &arena);
+        REQUIRE(l[4].value<std::int32_t>() == 3);
+    }
+}
+
+TEST_CASE("Benchmark memory resource", "[array][pmr]")
+{
+    auto d = np::descr_t::make<float>();
+    std::pmr::unsynchronized_pool_resource pool;
+
+    BENCHMARK("new / delete")
+    {
+        std::size_t s = 0;
+
+        for(int i = 0; i < 64; i++)
+            s += np::array(np::uninitialized, d, {256}).data_size();
+
+        return s;
+    };
+
+    BENCHMARK("monotonic arena per request")
+    {
+        std::pmr::monotonic_buffer_resource request(128 * 1024, &pool);
+        std::size_t s = 0;
+
+        for(int i = 0; i < 64; i++)
+            s += np::array(np::uninitialized, d, {256}, false, &request).data_size();
+
+        return s;
+    };
+
+    BENCHMARK("pool")
+    {
+        std::size_t s = 0;
+
+        for(int i = 0; i < 64; i++)
+            s += np::array(np::uninitialized, d, {256}, false, &pool).data_size();
+
+        return s;
+    };
+}
@@ -0,0 +1,32 @@
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include "global.h"
+
+TEST_CASE("npy reader", "[npy][reader]")
+{
+    bool read_ahead = GENERATE(false, true);
+
+    np::array huge = np::array::load(NPY_HUGE);
+    np::npy_reader r(NPY_HUGE, 1000, read_ahead);
+
+    REQUIRE(r.rows() == huge.size());
+    REQUIRE(r.chunk_rows() == 1000);
+    REQUIRE(r.info().descr == huge.descr());
+
+    np::array chunk;
+    std::size_t rows = 0;
+
+    while(r.next(chunk))
+    {
+        REQUIRE(chunk.dimensions() == 1);
+        REQUIRE(chunk.size() <= 1000);
+        REQUIRE(std::memcmp(chunk.data(), huge[rows].ptr(), chunk.data_size()) == 0);
+
+        rows += chunk.size();
+    }
+
+    REQUIRE(rows == huge.size());
+    REQUIRE_FALSE(r.next(chunk));
+
+    REQUIRE_THROWS(np::npy_reader(NPY_HUGE, 0));
+}
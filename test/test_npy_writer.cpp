@@ -0,0 +1,76 @@
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include "global.h"
+
+TEST_CASE("npy writer", "[npy][writer]")
+{
+    auto dst = std::filesystem::temp_directory_path() / "test_npy_writer.npy";
+
+    SECTION("C order")
+    {
+        np::array rows(np::descr_t::make<double>(), {4, 3});
+
+        for(std::size_t i = 0; i < rows.size(); i++)
+            rows[i].value<double>() = i;
+
+        {
+            np::npy_writer w(dst, np::descr_t::make<double>(), {3});
+
+            w.append(rows);
+            w.append(rows.data(), 2);
+
+            REQUIRE(w.rows() == 6);
+            REQUIRE(w.shape() == np::shape_t{6, 3});
+
+            REQUIRE_THROWS(w.append(np::array(np::descr_t::make<float>(), {4, 3})));
+            REQUIRE_THROWS(w.append(np::array(np::descr_t::make<double>(), {4, 2})));
+        }
+
+        np::array a = np::array::load(dst);
+
+        REQUIRE(a.shape() == np::shape_t{6, 3});
+        REQUIRE(a.at(3, 2).value<double>() == 11);
+        REQUIRE(a.at(5, 2).value<double>() == 5);
+        REQUIRE(np::array::inspect(dst).data_offset % 64 == 0);
+
+#ifdef USE_PYTHON3
+        std::string cmd = "python3 open_file_test.py " + dst.string();
+#else
+        std::string cmd = "pipenv run python open_file_test.py " + dst.string();
+#endif
+        INFO(cmd);
+        REQUIRE(std::system(cmd.c_str()) == 0);
+    }
+
+    SECTION("Fortran order")
+    {
+        int data[] = {1, 2, 3, 4, 5, 6};
+
+        np::npy_writer w(dst, np::descr_t::make<int>(), {2}, true);
+        w.append(data, 3);
+        w.close();
+
+        REQUIRE_FALSE(w.is_open());
+        REQUIRE_THROWS(w.append(data, 1));
+
+        np::array a = np::array::load(dst);
+
+        REQUIRE(a.shape() == np::shape_t{2, 3});
+        REQUIRE(a.fortran_order());
+        REQUIRE(a.at(1, 0).value<int>() == 2);
+        REQUIRE(a.at(0, 2).value<int>() == 5);
+    }
+
+#ifdef __linux__
+    SECTION("Write error on close")
+    {
+        int data[] = {1, 2, 3, 4, 5, 6};
+
+        np::npy_writer w("/dev/full", np::descr_t::make<int>(), {2});
+        w.append(data, 3);
+
+        REQUIRE_THROWS_AS(w.close(), np::error);
+        REQUIRE_FALSE(w.is_open());
+    }
+#endif
+}
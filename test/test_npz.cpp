@@ -70,3 +70,93 @@ TEMPLATE_TEST_CASE("Open npz file", "[npz]",
         REQUIRE_NOTHROW(a.at(0, 1, 2));
     }
 }
+
+TEST_CASE("npz container", "[npz]")
+{
+    np::npz z;
+
+    REQUIRE(z.empty());
+    REQUIRE_FALSE(z.contains("a"));
+    REQUIRE_THROWS_AS(z.at("a"), np::error);
+
+    z.reserve(3);
+
+    std::vector<std::string> names;
+
+    for(int i = 0; i < 100; i++)
+    {
+        names.push_back("array_" + std::to_string((i * 37) % 100));
+        REQUIRE(z.emplace(names.back(), np::array(np::descr_t::make<int>(), {std::size_t(i)})).second);
+    }
+
+    REQUIRE(z.size() == 100);
+    REQUIRE_FALSE(z.emplace(names[5], np::array()).second);
+    REQUIRE(z.at(names[5]).size() == 5);
+
+    // Insertion order
+    std::size_t i = 0;
+    for(auto& p : z)
+    {
+        REQUIRE(p.first == names[i]);
+        REQUIRE(p.second.size() == i);
+        i++;
+    }
+
+    std::string_view key = names[42];
+    REQUIRE(z.find(key)->second.size() == 42);
+
+    z.insert_or_assign(names[0], np::array(np::descr_t::make<int>(), {7}));
+    REQUIRE(z.begin()->second.size() == 7);
+
+    REQUIRE(z.erase(names[1]) == 1);
+    REQUIRE(z.erase(names[1]) == 0);
+    REQUIRE(z.size() == 99);
+    REQUIRE((z.begin() + 1)->first == names[2]);
+    REQUIRE(z.at(names[99]).size() == 99);
+
+    z["new"] = np::array(np::descr_t::make<int>(), {3});
+    REQUIRE((z.end() - 1)->first == "new");
+
+    z.clear();
+    REQUIRE(z.empty());
+    REQUIRE(z.count(names[2]) == 0);
+}
+
+TEST_CASE("npz references stay valid", "[npz]")
+{
+    np::npz z;
+
+    z["a"] = np::array(np::descr_t::make<int>(), {10});
+    z["a"][3].value<int>() = 42;
+
+    const np::array& a = z.at("a");
+
+    // Each right operand is evaluated first, then the new array is added
+    for(int i = 0; i < 200; i++)
+        z["b" + std::to_string(i)] = z["a"];
+
+    REQUIRE(z.size() == 201);
+    REQUIRE(&a == &z.at("a"));
+    REQUIRE(a[3].value<int>() == 42);
+    REQUIRE(z.at("b199").size() == 10);
+    REQUIRE(z.at("b199")[3].value<int>() == 42);
+}
+
+TEST_CASE("npz order", "[npz]")
+{
+    auto dst = fs::temp_directory_path() / "test_npz_order.npz";
+
+    np::npz z = np::npz_load(NPZ_TYPES);
+    np::npz_archive archive(NPZ_TYPES);
+
+    std::vector<std::string> names;
+    for(auto& p : z)
+        names.push_back(p.first);
+
+    REQUIRE(names == archive.names());
+
+    np::npz_save(z, dst);
+    REQUIRE(np::npz_archive(dst).names() == archive.names());
+
+    fs::remove(dst);
+}
@@ -0,0 +1,173 @@
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include "global.h"
+
+#include <fstream>
+
+TEST_CASE("npz archive", "[npz][archive]")
+{
+    auto file = GENERATE(NPZ_TYPES, NPZ_TYPES_COMPRESSED, NPZ_HUGE);
+
+    np::npz z = np::npz_load(file);
+    np::npz_archive archive(file);
+
+    REQUIRE(archive.path() == file);
+    REQUIRE(archive.size() == z.size());
+    REQUIRE(archive.names().size() == z.size());
+
+    for(auto& name : archive.names())
+    {
+        REQUIRE(archive.contains(name));
+
+        const np::array& expected = z.at(name);
+
+        np::header_info info = archive.inspect(name);
+        REQUIRE(info.descr == expected.descr());
+        REQUIRE(info.shape == expected.shape());
+
+        np::array a = archive.load(name);
+        REQUIRE(a.descr() == expected.descr());
+        REQUIRE(a.shape() == expected.shape());
+        REQUIRE(std::memcmp(a.data(), expected.data(), a.data_size()) == 0);
+    }
+
+    REQUIRE_FALSE(archive.contains("not_an_array"));
+    REQUIRE_THROWS_AS(archive.load("not_an_array"), np::error);
+    REQUIRE_THROWS_AS(archive.at("not_an_array"), np::error);
+}
+
+TEST_CASE("npz archive compressed", "[npz][archive]")
+{
+    np::npz_archive stored(NPZ_TYPES);
+    np::npz_archive compressed(NPZ_TYPES_COMPRESSED);
+
+    REQUIRE(stored.names() == compressed.names());
+
+    for(auto& name : compressed.names())
+    {
+        REQUIRE(stored.at(name).method == 0);
+        REQUIRE(compressed.at(name).method == 8);
+
+        np::array a = stored.load(name);
+        np::array b = compressed.load(name);
+
+        REQUIRE(a.data_size() == b.data_size());
+        REQUIRE(std::memcmp(a.data(), b.data(), a.data_size()) == 0);
+    }
+
+    REQUIRE_THROWS_AS(np::npz_archive(NPY_I8), np::error);
+}
+
+TEST_CASE("npz archive small deflated member", "[npz][archive]")
+{
+    // The whole member is consumed by the first header read, the rest of the
+    // header and the data are then only pending inside the inflater
+    auto dst = std::filesystem::temp_directory_path() / "test_npz_small_deflated.npz";
+
+    np::array a(np::descr_t::make<std::int64_t>(), {1000});
+
+    for(std::size_t i = 0; i < a.size(); i++)
+        a[i].value<std::int64_t>() = static_cast<std::int64_t>(i);
+
+    {
+        np::npz_writer w(dst, 6);
+        w.add("a", a);
+        w.close();
+    }
+
+    np::npz_archive archive(dst);
+
+    REQUIRE(archive.at("a").method == 8);
+    REQUIRE(archive.at("a").compressed_size < archive.at("a").size);
+    REQUIRE(archive.inspect("a").shape == a.shape());
+
+    np::array b = archive.load("a");
+    REQUIRE(b.shape() == a.shape());
+    REQUIRE(std::memcmp(b.data(), a.data(), a.data_size()) == 0);
+
+    np::npz z = np::npz_load(dst);
+    REQUIRE(z.at("a").at(999).value<std::int64_t>() == 999);
+}
+
+TEST_CASE("npz archive empty member name", "[npz][archive]")
+{
+    auto dst = std::filesystem::temp_directory_path() / "test_npz_empty_name.npz";
+
+    {
+        np::npz_writer w(dst);
+        w.add("a", np::array(np::descr_t::make<int>(), {4}));
+        w.close();
+    }
+
+    std::string zip;
+    {
+        std::ifstream in(dst, std::ios::binary);
+        zip.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    // Moves the name of the central directory entry into its comment
+    std::size_t h = zip.find("PK\x01\x02");
+    REQUIRE(h != std::string::npos);
+    REQUIRE(zip[h + 28] == 5);
+
+    zip[h + 28] = 0;
+    zip[h + 32] = static_cast<char>(zip[h + 32] + 5);
+
+    {
+        std::ofstream out(dst, std::ios::binary);
+        out.write(zip.data(), static_cast<std::streamsize>(zip.size()));
+    }
+
+    REQUIRE_THROWS_AS(np::npz_archive(dst), np::error);
+}
+
+TEST_CASE("npz archive mapped", "[npz][archive][map]")
+{
+    auto file = GENERATE(NPZ_TYPES, NPZ_TYPES_COMPRESSED);
+
+    np::npz_archive archive(file);
+    np::npz_archive mapped(file, np::ReadOnly);
+
+    REQUIRE(mapped.mapped());
+    REQUIRE_FALSE(archive.mapped());
+
+    for(auto& name : mapped.names())
+    {
+        np::array a = archive.load(name);
+        np::array b = mapped.load(name);
+
+        REQUIRE(b.mapped() == (mapped.at(name).method == 0));
+        REQUIRE(b.descr() == a.descr());
+        REQUIRE(b.shape() == a.shape());
+        REQUIRE(std::memcmp(a.data(), b.data(), a.data_size()) == 0);
+    }
+
+    np::npz z = np::npz_map(NPZ_TYPES);
+    for(auto& p : z)
+        REQUIRE(p.second.mapped());
+
+    REQUIRE_THROWS_AS(np::npz_archive(file, np::ReadWrite), np::error);
+}
+
+TEST_CASE("npz archive ZIP64", "[npz][archive][zip64]")
+{
+    np::npz_archive types(NPZ_TYPES);
+    np::npz_archive archive(NPZ_ZIP64);
+    np::npz_archive mapped(NPZ_ZIP64, np::ReadOnly);
+
+    REQUIRE(archive.names() == std::vector<std::string>{"int32", "float64", "string"});
+
+    for(auto& name : archive.names())
+    {
+        REQUIRE(archive.at(name).size == types.at(name).size);
+
+        np::array expected = types.load(name);
+        np::array a = archive.load(name);
+        np::array b = mapped.load(name);
+
+        REQUIRE(b.mapped());
+        REQUIRE(a.shape() == expected.shape());
+        REQUIRE(std::memcmp(a.data(), expected.data(), a.data_size()) == 0);
+        REQUIRE(std::memcmp(b.data(), expected.data(), b.data_size()) == 0);
+    }
+}
@@ -0,0 +1,127 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include "global.h"
+
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+
+std::string read_all(const fs::path& file)
+{
+    std::ifstream st(file, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(st), {});
+}
+
+np::npz make_arrays(std::size_t count, std::size_t size)
+{
+    np::npz z;
+
+    for(std::size_t k = 0; k < count; k++)
+    {
+        np::array a(np::uninitialized, np::descr_t::make<float>(), {size});
+        float* d = const_cast<float*>(a.data_as<float>());
+
+        for(std::size_t i = 0; i < size; i++)
+            d[i] = static_cast<float>((i * 7919 + k) % 1000) * 0.5f;
+
+        z.emplace("array_" + std::to_string(k), std::move(a));
+    }
+
+    return z;
+}
+
+}
+
+TEST_CASE("Parallel npz", "[npz][parallel]")
+{
+    auto serial   = fs::temp_directory_path() / "test_npz_serial.npz";
+    auto parallel = fs::temp_directory_path() / "test_npz_parallel.npz";
+
+    np::npz z = np::npz_load(NPZ_HUGE);
+
+    np::npz_save(z, serial);
+    np::npz_save(z, parallel, 0);
+
+    // Same archive whatever the number of threads
+    REQUIRE(read_all(serial) == read_all(parallel));
+
+    std::size_t threads = GENERATE(1, 2, 0);
+    np::npz l = np::npz_load(parallel, threads);
+
+    REQUIRE(l.size() == z.size());
+
+    for(auto& p : z)
+    {
+        const np::array& a = l.at(p.first);
+
+        REQUIRE(a.descr() == p.second.descr());
+        REQUIRE(a.shape() == p.second.shape());
+        REQUIRE(std::memcmp(a.data(), p.second.data(), a.data_size()) == 0);
+    }
+
+    REQUIRE_THROWS_AS(np::npz_load(NPY_I8, threads), np::error);
+}
+
+TEST_CASE("Benchmark parallel npz", "[npz][parallel]")
+{
+    auto dst = fs::temp_directory_path() / "bench_npz_parallel.npz";
+
+    // 64 arrays of 4MB
+    np::npz z = make_arrays(64, 1 << 20);
+
+    BENCHMARK("npz_save 1 thread")
+    {
+        np::npz_save(z, dst);
+    };
+
+    BENCHMARK("npz_save all cores")
+    {
+        np::npz_save(z, dst, 0);
+    };
+
+    BENCHMARK("npz_load 1 thread")
+    {
+        return np::npz_load(dst);
+    };
+
+    BENCHMARK("npz_load all cores")
+    {
+        return np::npz_load(dst, 0);
+    };
+
+    fs::remove(dst);
+}
+
+TEST_CASE("Compressed npz", "[npz][compressed]")
+{
+    auto dst = fs::temp_directory_path() / "test_npz_compressed.npz";
+
+    np::npz z = np::npz_load(NPZ_TYPES);
+
+    int level = GENERATE(0, 1, 6, 9);
+    np::npz_save_compressed(z, dst, level);
+
+    np::npz_archive archive(dst);
+
+    for(auto& name : archive.names())
+        REQUIRE(archive.at(name).method == (level == 0 ? 0 : 8));
+
+    np::npz l = np::npz_load(dst);
+
+    REQUIRE(l.size() == z.size());
+
+    for(auto& p : z)
+    {
+        const np::array& a = l.at(p.first);
+
+        REQUIRE(a.descr() == p.second.descr());
+        REQUIRE(a.shape() == p.second.shape());
+        REQUIRE(std::memcmp(a.data(), p.second.data(), a.data_size()) == 0);
+    }
+
+    REQUIRE_THROWS_AS(np::npz_save_compressed(z, dst, 10), np::error);
+    REQUIRE_THROWS_AS(np::npz_save_compressed(z, dst, -1), np::error);
+}
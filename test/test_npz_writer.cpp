@@ -0,0 +1,109 @@
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include "global.h"
+
+#include <cstring>
+
+TEST_CASE("npz writer", "[npz][writer]")
+{
+    auto dst = fs::temp_directory_path() / "test_npz_writer.npz";
+
+    np::array weights(np::descr_t::make<double>(), {4, 3});
+
+    for(std::size_t i = 0; i < weights.size(); i++)
+        weights[i].value<double>() = i;
+
+    SECTION("Arrays and streams")
+    {
+        int level = GENERATE(0, 6);
+
+        {
+            np::npz_writer w(dst, level);
+
+            w.add("weights", weights);
+
+            auto m = w.add_stream("log", np::descr_t::make<float>(), {5, 2});
+
+            REQUIRE(m.total_rows() == 5);
+            REQUIRE(m.row_size() == 2 * sizeof (float));
+
+            // Only one member at a time
+            REQUIRE_THROWS_AS(w.add("other", weights), np::error);
+
+            float data[] = {0, 1, 2, 3, 4, 5};
+            m.append(data, 3);
+            m.append(np::array(np::descr_t::make<float>(), {2, 2}));
+
+            REQUIRE(m.rows() == 5);
+            REQUIRE_THROWS_AS(m.append(data, 1), np::error);
+
+            m.close();
+
+            REQUIRE_FALSE(m.is_open());
+            REQUIRE_THROWS_AS(w.add("weights", weights), np::error);
+
+            w.add("empty", np::array(np::descr_t::make<int>(), {0}));
+            w.close();
+
+            REQUIRE(w.size() == 3);
+            REQUIRE_FALSE(w.is_open());
+        }
+
+        np::npz_archive archive(dst);
+
+        REQUIRE(archive.names() == std::vector<std::string>{"weights", "log", "empty"});
+        REQUIRE(archive.at("log").method == (level == 0 ? 0 : 8));
+
+        np::array a = archive.load("weights");
+
+        REQUIRE(a.shape() == weights.shape());
+        REQUIRE(std::memcmp(a.data(), weights.data(), a.data_size()) == 0);
+
+        np::array log = archive.load("log");
+
+        REQUIRE(log.shape() == np::shape_t{5, 2});
+        REQUIRE(log.at(2, 1).value<float>() == 5);
+
+        REQUIRE(archive.load("empty").empty());
+    }
+
+    SECTION("ZIP64 directory")
+    {
+        // More members than a 16 bits count can hold
+        std::size_t count = 0x10000;
+        np::array one(np::descr_t::make<std::uint32_t>(), {1});
+
+        {
+            np::npz_writer w(dst);
+
+            for(std::size_t i = 0; i < count; i++)
+            {
+                one[0].value<std::uint32_t>() = static_cast<std::uint32_t>(i);
+                w.add(std::to_string(i), one);
+            }
+        }
+
+        np::npz_archive archive(dst);
+
+        REQUIRE(archive.size() == count);
+        REQUIRE(archive.load("65535")[0].value<std::uint32_t>() == 65535);
+    }
+
+    SECTION("Missing rows")
+    {
+        np::npz_writer w(dst);
+
+        auto m = w.add_stream("log", np::descr_t::make<float>(), {5, 2});
+
+        float data[] = {0, 1, 2, 3};
+        m.append(data, 2);
+
+        REQUIRE_THROWS_AS(m.close(), np::error);
+
+        // The archive can't be completed
+        REQUIRE_THROWS_AS(w.add("weights", weights), np::error);
+        REQUIRE_THROWS_AS(w.close(), np::error);
+    }
+
+    fs::remove(dst);
+}
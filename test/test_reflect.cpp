@@ -0,0 +1,128 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include "global.h"
+
+#include <sstream>
+
+namespace
+{
+
+struct trade
+{
+    std::int64_t ts;
+    float        price;
+    std::int32_t qty;
+    bool         flag;
+};
+
+struct padded
+{
+    std::uint8_t a;
+    double       b;
+    std::int16_t c;
+};
+
+}
+
+NP_REFLECT(trade, ts, price, qty, flag)
+NP_REFLECT(padded, a, b, c)
+
+TEST_CASE("Reflected descr", "[reflect]")
+{
+    np::descr_t d = np::record_traits<trade>::descr();
+
+    REQUIRE(d.size() == 4);
+    REQUIRE(d.stride() == sizeof (trade));
+    REQUIRE(d["ts"].offset() == offsetof(trade, ts));
+    REQUIRE(d["price"].offset() == offsetof(trade, price));
+    REQUIRE(d["qty"].offset() == offsetof(trade, qty));
+    REQUIRE(d["flag"].offset() == offsetof(trade, flag));
+
+    np::descr_t p = np::record_traits<padded>::descr();
+
+    REQUIRE(p.stride() == sizeof (padded));
+    REQUIRE(p["b"].offset() == offsetof(padded, b));
+
+    // The padding is written as numpy does for aligned dtypes, and read back
+    np::descr_t r = np::descr_t::from_string(p.to_string());
+    REQUIRE(r.to_string() == p.to_string());
+    REQUIRE(r.stride() == p.stride());
+    REQUIRE(r["c"].offset() == p["c"].offset());
+
+    REQUIRE_THROWS_AS(p.push_back(np::type_t::from_type<int>(), "d", 0), np::error);
+    REQUIRE_THROWS_AS(p.set_stride(1), np::error);
+}
+
+TEST_CASE("Records from numpy aligned dtype", "[reflect][array]")
+{
+    np::array a = np::array::load(NPY_ALIGNED);
+
+    REQUIRE(a.descr().to_string() == np::record_traits<trade>::descr().to_string());
+
+    auto records = a.as_records<trade>();
+
+    REQUIRE(records.size() == 100);
+
+    for(std::size_t i = 0; i < records.size(); i++)
+    {
+        REQUIRE(records[i].ts == static_cast<std::int64_t>(i) * 1000);
+        REQUIRE(records[i].price == static_cast<float>(i) * 0.5f);
+        REQUIRE(records[i].qty == static_cast<std::int32_t>(i) * -3);
+        REQUIRE(records[i].flag == (i % 2 == 0));
+    }
+}
+
+TEST_CASE("Array from records", "[reflect][array]")
+{
+    std::vector<padded> v(50);
+
+    for(std::size_t i = 0; i < v.size(); i++)
+        v[i] = padded{static_cast<std::uint8_t>(i), i * 1.5, static_cast<std::int16_t>(-i)};
+
+    np::array a = np::array::from_records(v);
+
+    REQUIRE(a.shape() == np::shape_t{50});
+    REQUIRE(a.descr().stride() == sizeof (padded));
+    REQUIRE(a[7].value<double>("b") == 10.5);
+    REQUIRE(a[7].value<std::int16_t>("c") == -7);
+
+    std::stringstream ss;
+    a.save(ss);
+
+    np::array b = np::array::load(ss);
+    auto records = b.as_records<padded>();
+
+    REQUIRE(b.descr().to_string() == a.descr().to_string());
+    REQUIRE(records[49].a == 49);
+    REQUIRE(records[49].b == 73.5);
+    REQUIRE(records[49].c == -49);
+
+    REQUIRE(np::array::from_records(std::vector<trade>()).size() == 0);
+}
+
+TEST_CASE("Benchmark from records", "[reflect][array]")
+{
+    std::vector<trade> v(1000000);
+
+    BENCHMARK("per field")
+    {
+        np::array a(np::uninitialized, np::record_traits<trade>::descr(), {v.size()});
+
+        for(std::size_t i = 0; i < v.size(); i++)
+        {
+            auto it = a[i];
+            it.value<std::int64_t>("ts")  = v[i].ts;
+            it.value<float>("price")      = v[i].price;
+            it.value<std::int32_t>("qty") = v[i].qty;
+            it.value<bool>("flag")        = v[i].flag;
+        }
+
+        return a;
+    };
+
+    BENCHMARK("from_records")
+    {
+        return np::array::from_records(v);
+    };
+}
@@ -0,0 +1,100 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include "global.h"
+
+TEST_CASE("Reshape", "[array][reshape]")
+{
+    bool fortran = GENERATE(false, true);
+
+    np::array a = make_iota<int>({4, 6}, fortran);
+    const char* data = a.data();
+
+    SECTION("reshape")
+    {
+        a.reshape({2, 3, 4});
+
+        REQUIRE(a.shape() == np::shape_t{2, 3, 4});
+        REQUIRE(a.strides() == np::element_strides(a.shape(), fortran));
+        REQUIRE(a.data() == data);
+        REQUIRE(a.at(1, 2, 3).value<int>() == static_cast<int>(a.index(1, 2, 3)));
+
+        REQUIRE_THROWS_AS(a.reshape({5, 5}), np::error);
+        REQUIRE(a.shape() == np::shape_t{2, 3, 4});
+    }
+
+    SECTION("squeeze and expand_dims")
+    {
+        a.expand_dims(0);
+        a.expand_dims(2);
+        a.expand_dims(4);
+
+        REQUIRE(a.shape() == np::shape_t{1, 4, 1, 6, 1});
+        REQUIRE(a.at(0, 3, 0, 5, 0).value<int>() == 23);
+        REQUIRE(a.at(0, 1, 0, 2, 0).value<int>() == (fortran ? 9 : 8));
+
+        a.squeeze(2);
+        REQUIRE(a.shape() == np::shape_t{1, 4, 6, 1});
+
+        a.squeeze();
+        REQUIRE(a.shape() == np::shape_t{4, 6});
+        REQUIRE(a.data() == data);
+
+        REQUIRE_THROWS_AS(a.squeeze(0), np::error);
+        REQUIRE_THROWS_AS(a.squeeze(2), np::error);
+        REQUIRE_THROWS_AS(a.expand_dims(3), np::error);
+
+        np::array one = make_iota<int>({1, 1, 1}, fortran);
+        one.squeeze();
+        REQUIRE(one.shape() == np::shape_t{1});
+        REQUIRE_THROWS_AS(one.squeeze(0), np::error);
+
+        REQUIRE_THROWS_AS(np::array().expand_dims(0), np::error);
+    }
+
+    SECTION("ravel")
+    {
+        a.ravel();
+
+        REQUIRE(a.shape() == np::shape_t{24});
+        REQUIRE(a.data() == data);
+
+        for(std::size_t i = 0; i < 24; i++)
+            REQUIRE(a.at(i).value<int>() == static_cast<int>(i));
+
+        np::array e;
+        e.ravel();
+        REQUIRE(e.shape().empty());
+    }
+
+    SECTION("view")
+    {
+        auto v = a.view().reshape({6, 4});
+
+        REQUIRE(v.data() == data);
+        REQUIRE(v.at(5, 3).value<int>() == 23);
+
+        REQUIRE_THROWS_AS(a.slice({{0, 2}, {0, 2}}).reshape({4}), np::error);
+        REQUIRE(a.slice({{0, 2}, {0, 2}}).contiguous().view().reshape({4}).size() == 4);
+        REQUIRE_THROWS_AS(a.view().reshape({5}), np::error);
+    }
+}
+
+TEST_CASE("Benchmark reshape", "[array][reshape]")
+{
+    np::array a(np::uninitialized, np::descr_t::make<float>(), {64, 1024, 1024});
+
+    BENCHMARK("copy into a new shape")
+    {
+        np::array b(np::uninitialized, a.descr(), {1024, 64, 1024});
+        std::memcpy(const_cast<char*>(b.data()), a.data(), a.data_size());
+        return b;
+    };
+
+    BENCHMARK("reshape")
+    {
+        a.reshape({1024, 64, 1024});
+        a.reshape({64, 1024, 1024});
+        return a.data();
+    };
+}
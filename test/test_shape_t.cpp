@@ -0,0 +1,179 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+
+namespace
+{
+
+bool is_inline(const np::shape_t& s)
+{
+    auto p = reinterpret_cast<const char*>(s.data());
+    auto o = reinterpret_cast<const char*>(&s);
+
+    return p >= o && p < o + sizeof (s);
+}
+
+}
+
+TEST_CASE("shape_t", "[shape]")
+{
+    SECTION("Inline")
+    {
+        np::shape_t s = {3, 4, 5};
+
+        REQUIRE(s.size() == 3);
+        REQUIRE(s[1] == 4);
+        REQUIRE(s.back() == 5);
+        REQUIRE(is_inline(s));
+        REQUIRE(np::shape_to_string(s) == "(3,4,5,)");
+
+        for(std::size_t i = 3; i < np::shape_t::inline_capacity; i++)
+            s.push_back(i);
+
+        REQUIRE(is_inline(s));
+
+        np::shape_t c = s;
+        REQUIRE(c == s);
+        REQUIRE(is_inline(c));
+    }
+
+    SECTION("Heap fallback")
+    {
+        np::shape_t s(12, 2);
+
+        REQUIRE(s.size() == 12);
+        REQUIRE(!is_inline(s));
+        REQUIRE(std::all_of(s.begin(), s.end(), [](std::size_t d){ return d == 2; }));
+
+        np::shape_t c = s;
+        REQUIRE(c == s);
+
+        const std::size_t* data = s.data();
+        np::shape_t m = std::move(s);
+        REQUIRE(m.data() == data);
+        REQUIRE(m == c);
+        REQUIRE(s.empty());
+
+        m = {1, 2};
+        REQUIRE(m == np::shape_t{1, 2});
+
+        np::shape_t small = {7};
+        small.swap(c);
+        REQUIRE(small.size() == 12);
+        REQUIRE(c == np::shape_t{7});
+    }
+
+    SECTION("Edit")
+    {
+        np::shape_t s = {1, 2, 3};
+
+        s.insert(s.begin(), 0);
+        REQUIRE(s == np::shape_t{0, 1, 2, 3});
+
+        s.erase(s.begin() + 2);
+        REQUIRE(s == np::shape_t{0, 1, 3});
+
+        s.resize(5, 9);
+        REQUIRE(s == np::shape_t{0, 1, 3, 9, 9});
+
+        s.pop_back();
+        s.resize(2);
+        REQUIRE(s == np::shape_t{0, 1});
+        REQUIRE(s != np::shape_t{0, 1, 3});
+
+        REQUIRE(np::shape_t(std::vector<std::size_t>{4, 5}) == np::shape_t{4, 5});
+        REQUIRE_THROWS_AS(s.at(2), np::error);
+
+        std::vector<std::size_t> v = {7, 8, 9};
+
+        s.insert(s.begin() + 1, v.begin(), v.end());
+        REQUIRE(s == np::shape_t{0, 7, 8, 9, 1});
+
+        s.assign(v.begin() + 1, v.end());
+        REQUIRE(s == np::shape_t{8, 9});
+
+        s.assign(10, 3);
+        REQUIRE(s.size() == 10);
+        REQUIRE(s.back() == 3);
+
+        s.assign({5, 6});
+        REQUIRE(s == np::shape_t{5, 6});
+
+        // Ranges from the shape itself, growing to the heap on the way
+        for(int i = 0; i < 3; i++)
+            s.insert(s.end(), s.begin(), s.end());
+
+        REQUIRE(s.size() == 16);
+        REQUIRE(s[14] == 5);
+        REQUIRE(s[15] == 6);
+
+        s.insert(s.begin() + 1, s.begin(), s.end());
+        REQUIRE(s.size() == 32);
+        REQUIRE(s[1] == 5);
+        REQUIRE(s[16] == 6);
+        REQUIRE(s[17] == 6);
+
+        s.assign(s.begin() + 30, s.end());
+        REQUIRE(s == np::shape_t{5, 6});
+    }
+
+    SECTION("std::vector")
+    {
+        std::vector<std::size_t> v = {2, 3, 4};
+        np::shape_t s = v;
+
+        REQUIRE(s == v);
+        REQUIRE(v == s);
+        REQUIRE(s != std::vector<std::size_t>{2, 3});
+        REQUIRE(static_cast<std::vector<std::size_t>>(s) == v);
+
+        np::shape_t big(10, 1);
+        REQUIRE(std::vector<std::size_t>(big) == std::vector<std::size_t>(10, 1));
+    }
+}
+
+TEST_CASE("Benchmark shape_t", "[shape]")
+{
+    np::descr_t d = np::descr_t::make<float>();
+
+    BENCHMARK("copy std::vector shape")
+    {
+        std::vector<std::size_t> s = {32, 32, 3};
+        std::size_t sum = 0;
+
+        for(int i = 0; i < 100000; i++)
+        {
+            std::vector<std::size_t> c = s;
+            sum += c[i % 3];
+        }
+
+        return sum;
+    };
+
+    BENCHMARK("copy shape_t")
+    {
+        np::shape_t s = {32, 32, 3};
+        std::size_t sum = 0;
+
+        for(int i = 0; i < 100000; i++)
+        {
+            np::shape_t c = s;
+            sum += c[i % 3];
+        }
+
+        return sum;
+    };
+
+    BENCHMARK("make small arrays")
+    {
+        std::size_t sum = 0;
+
+        for(int i = 0; i < 100000; i++)
+        {
+            np::array a(np::uninitialized, d, {4, 4});
+            sum += a.size();
+        }
+
+        return sum;
+    };
+}
@@ -0,0 +1,148 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include "global.h"
+
+TEST_CASE("Change order", "[array][transpose]")
+{
+    bool fortran = GENERATE(false, true);
+    std::size_t threads = GENERATE(1, 3);
+
+    np::array a = make_iota<double>({70, 45, 3}, fortran);
+    np::array b = a;
+
+    if(fortran)
+        b.to_c_order(threads);
+    else
+        b.to_fortran_order(threads);
+
+    REQUIRE(b.fortran_order() == !fortran);
+    REQUIRE(b.shape() == a.shape());
+
+    std::size_t mismatches = 0;
+
+    for(std::size_t i = 0; i < 70; i++)
+        for(std::size_t j = 0; j < 45; j++)
+            for(std::size_t k = 0; k < 3; k++)
+                if(a.at(i, j, k).value<double>() != b.at(i, j, k).value<double>())
+                    mismatches++;
+
+    REQUIRE(mismatches == 0);
+
+    // Back and forth gives the same bytes
+    if(fortran)
+        b.to_fortran_order(threads);
+    else
+        b.to_c_order(threads);
+
+    REQUIRE(std::memcmp(a.data(), b.data(), a.data_size()) == 0);
+
+    np::array v = make_iota<int>({10}, fortran);
+    v.to_fortran_order();
+    v.to_c_order();
+    REQUIRE(v.at(7).value<int>() == 7);
+}
+
+TEST_CASE("Transpose", "[array][transpose]")
+{
+    bool fortran = GENERATE(false, true);
+
+    np::array a = make_iota<std::int16_t>({5, 67, 40}, fortran);
+
+    SECTION("Reversed axes")
+    {
+        np::array t = a.transpose();
+
+        REQUIRE(t.shape() == np::shape_t{40, 67, 5});
+        REQUIRE(t.fortran_order() == fortran);
+
+        std::size_t mismatches = 0;
+
+        for(std::size_t i = 0; i < 5; i++)
+            for(std::size_t j = 0; j < 67; j++)
+                for(std::size_t k = 0; k < 40; k++)
+                    if(a.at(i, j, k).value<std::int16_t>() != t.at(k, j, i).value<std::int16_t>())
+                        mismatches++;
+
+        REQUIRE(mismatches == 0);
+    }
+
+    SECTION("Permuted axes")
+    {
+        np::array t = a.transpose({1, 0, 2}, 2);
+
+        REQUIRE(t.shape() == np::shape_t{67, 5, 40});
+
+        std::size_t mismatches = 0;
+
+        for(std::size_t i = 0; i < 5; i++)
+            for(std::size_t j = 0; j < 67; j++)
+                for(std::size_t k = 0; k < 40; k++)
+                    if(a.at(i, j, k).value<std::int16_t>() != t.at(j, i, k).value<std::int16_t>())
+                        mismatches++;
+
+        REQUIRE(mismatches == 0);
+        REQUIRE(t.transpose({1, 0, 2}).at(4, 66, 39).value<std::int16_t>() == a.at(4, 66, 39).value<std::int16_t>());
+    }
+
+    SECTION("Bad axes")
+    {
+        REQUIRE_THROWS_AS(a.transpose({0, 1}), np::error);
+        REQUIRE_THROWS_AS(a.transpose({0, 1, 1}), np::error);
+        REQUIRE_THROWS_AS(a.transpose({0, 1, 3}), np::error);
+    }
+}
+
+TEST_CASE("Transpose structured array", "[array][transpose]")
+{
+    np::array a = np::array::load(NPY_HUGE);
+    np::array m(np::uninitialized, a.descr(), {a.size() / 100, 100});
+    std::memcpy(const_cast<char*>(m.data()), a.data(), m.data_size());
+
+    np::array t = m.transpose();
+
+    REQUIRE(t.at(42, 3).value<std::int64_t>("timestamp") == m.at(3, 42).value<std::int64_t>("timestamp"));
+    REQUIRE(t.at(99, 0).value<double>("wind_sp") == m.at(0, 99).value<double>("wind_sp"));
+}
+
+TEST_CASE("Benchmark transpose", "[array][transpose]")
+{
+    np::array a(np::descr_t::make<double>(), {2048, 2048});
+
+    BENCHMARK("element by element")
+    {
+        np::array b(np::uninitialized, a.descr(), a.shape(), true);
+
+        for(std::size_t i = 0; i < 2048; i++)
+            for(std::size_t j = 0; j < 2048; j++)
+                b.at(i, j).value<double>() = a.at(i, j).value<double>();
+
+        return b;
+    };
+
+    BENCHMARK("to_fortran_order and back")
+    {
+        a.to_fortran_order();
+        a.to_c_order();
+        return a.data();
+    };
+}
+
+TEST_CASE("Benchmark transpose 8k", "[.][array][transpose]")
+{
+    np::array a(np::descr_t::make<double>(), {8192, 8192}, true);
+
+    BENCHMARK("to_c_order")
+    {
+        a.to_c_order();
+        a.to_fortran_order();
+        return a.data();
+    };
+
+    BENCHMARK("to_c_order, 0 threads")
+    {
+        a.to_c_order(0);
+        a.to_fortran_order(0);
+        return a.data();
+    };
+}
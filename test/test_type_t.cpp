@@ -60,6 +60,8 @@ TEST_CASE("type_t unit test", "[array]")
         REQUIRE_THROWS(np::type_t::from_string("test"));
         REQUIRE_THROWS(np::type_t::from_string("'test'"));
         REQUIRE_THROWS(np::type_t::from_string("\"test\""));
+        REQUIRE_THROWS(np::type_t::from_string("'<U99999999999999999999'"));
+        REQUIRE_THROWS(np::type_t::from_string("'<U9223372036854775807'"));
 
         REQUIRE_THROWS(np::type_t::from_string("=O2"));
         REQUIRE_THROWS(np::type_t::from_string("<i16"));
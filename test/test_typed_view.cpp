@@ -0,0 +1,124 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch_all.hpp>
+#include <numpycpp/numpycpp.h>
+#include "global.h"
+
+TEST_CASE("Typed view", "[array][view]")
+{
+    bool fortran = GENERATE(false, true);
+
+    np::array a(np::descr_t::make<int>(), {2, 3, 4}, fortran);
+
+    for(std::size_t i = 0; i < a.size(); i++)
+        a[i].value<int>() = static_cast<int>(i);
+
+    auto v = a.as<int>();
+
+    REQUIRE(v.size() == a.size());
+    REQUIRE(v.dimensions() == 3);
+    REQUIRE(v.shape() == a.shape());
+    REQUIRE(v.data() == a.data_as<int>());
+    REQUIRE(v.end() - v.begin() == 24);
+
+    for(std::size_t i = 0; i < 2; i++)
+        for(std::size_t j = 0; j < 3; j++)
+            for(std::size_t k = 0; k < 4; k++)
+                REQUIRE(v(i, j, k) == a.at(i, j, k).value<int>());
+
+    REQUIRE_THROWS_AS(v.at(2, 0, 0), np::error);
+    REQUIRE_THROWS_AS(v.at(0, 0), np::error);
+    REQUIRE_NOTHROW(v.at(1, 2, 3));
+
+    for(int& x : v)
+        x *= 2;
+
+    REQUIRE(a[5].value<int>() == 10);
+
+    const np::array& c = a;
+    auto cv = c.as<int>();
+    REQUIRE(cv[5] == 10);
+
+    REQUIRE_THROWS_AS(a.as<float>(), np::error);
+    REQUIRE_THROWS_AS(a.as<short>(), np::error);
+
+    a.convert_to(np::OpositeEndian);
+    REQUIRE_THROWS_AS(a.as<int>(), np::error);
+
+    np::array s = np::array::load(NPY_HUGE);
+    REQUIRE_THROWS_AS(s.as<std::int64_t>(), np::error);
+
+    REQUIRE_THROWS_AS(np::array().as<int>(), np::error);
+    REQUIRE(np::array(np::descr_t::make<int>(), {0}).as<int>().empty());
+}
+
+TEST_CASE("Typed view of padded elements", "[array][view]")
+{
+    np::descr_t d;
+    d.push_back(np::type_t::from_type<double>(), "x", 0);
+    d.set_stride(16);
+
+    np::array a(d, {3});
+
+    for(std::size_t i = 0; i < 3; i++)
+        a[i].value<double>("x") = static_cast<double>(i + 1);
+
+    REQUIRE_THROWS_AS(a.as<double>(), np::error);
+
+    auto x = a.field<double>("x");
+    REQUIRE(x[0] == 1.0);
+    REQUIRE(x[1] == 2.0);
+    REQUIRE(x[2] == 3.0);
+
+    np::descr_t o;
+    o.push_back(np::type_t::from_type<double>(), "x", 8);
+
+    REQUIRE_THROWS_AS(np::array(o, {3}).as<double>(), np::error);
+}
+
+TEST_CASE("Benchmark typed view", "[array][view]")
+{
+    np::array a(np::descr_t::make<double>(), {1000, 1000});
+
+    BENCHMARK("iterator")
+    {
+        double sum = 0;
+
+        for(auto it : a)
+            sum += it.value<double>();
+
+        return sum;
+    };
+
+    BENCHMARK("typed view")
+    {
+        double sum = 0;
+
+        for(double d : a.as<double>())
+            sum += d;
+
+        return sum;
+    };
+
+    BENCHMARK("array::at")
+    {
+        double sum = 0;
+
+        for(std::size_t i = 0; i < 1000; i++)
+            for(std::size_t j = 0; j < 1000; j += 10)
+                sum += a.at(i, j).value<double>();
+
+        return sum;
+    };
+
+    BENCHMARK("typed view operator()")
+    {
+        auto v = a.as<double>();
+        double sum = 0;
+
+        for(std::size_t i = 0; i < 1000; i++)
+            for(std::size_t j = 0; j < 1000; j += 10)
+                sum += v(i, j);
+
+        return sum;
+    };
+}